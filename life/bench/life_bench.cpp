@@ -0,0 +1,593 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+#include <common/size.hpp>
+#include <graphics/color.hpp>
+#include <log/log.hpp>
+#include <log/stream_logger.hpp>
+#include <math/math.hpp>
+
+#include "components.hpp"
+#include "counter_random.hpp"
+#include "ecs.hpp"
+#include "job_system.hpp"
+#include "movement_kernel.hpp"
+#include "movement_system.hpp"
+#include "quad_batch.hpp"
+#include "snapshot.hpp"
+#include "view_culling.hpp"
+
+namespace N = neutrino;
+namespace NG = neutrino::graphics;
+namespace NM = neutrino::math;
+namespace NL = neutrino::log;
+
+// Every allocation of the process is counted, so steady state frames can be checked to not allocate.
+namespace
+{
+    std::atomic<std::uint64_t> allocations_count = 0;
+
+    void *counted_allocation(std::size_t size, std::size_t alignment = 0)
+    {
+        allocations_count.fetch_add(1, std::memory_order_relaxed);
+
+        void *p = nullptr;
+        if (alignment > alignof(std::max_align_t))
+        {
+#if defined(_MSC_VER)
+            p = _aligned_malloc(std::max<std::size_t>(size, 1), alignment);
+#else
+            // aligned_alloc requires the size to be a multiple of the alignment.
+            p = std::aligned_alloc(alignment, (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment);
+#endif
+        }
+        else
+        {
+            p = std::malloc(std::max<std::size_t>(size, 1));
+        }
+
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return p;
+    }
+
+    void aligned_free(void *p)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocation(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocation(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(p);
+}
+
+namespace
+{
+    const N::Size WorldSize = {800, 600};
+
+    // Hardware cache misses of the process, including threads created after the counter.
+    // Not available outside of Linux or when perf events are restricted.
+    class CacheMissCounter
+    {
+    public:
+        CacheMissCounter()
+        {
+#if defined(__linux__)
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~CacheMissCounter()
+        {
+#if defined(__linux__)
+            if (m_fd != -1)
+            {
+                close(m_fd);
+            }
+#endif
+        }
+
+        CacheMissCounter(const CacheMissCounter &) = delete;
+        CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+        bool available() const
+        {
+            return m_fd != -1;
+        }
+
+        std::uint64_t read() const
+        {
+            std::uint64_t value = 0;
+#if defined(__linux__)
+            if (m_fd != -1 && ::read(m_fd, &value, sizeof(value)) != sizeof(value))
+            {
+                value = 0;
+            }
+#endif
+            return value;
+        }
+
+    private:
+        int m_fd = -1;
+    };
+
+    struct Config
+    {
+        std::vector<std::size_t> entities_counts = {10000, 100000, 1000000};
+        std::size_t frames_count = 200;
+        std::size_t warmup_frames_count = 20;
+        std::size_t workers_count = JobSystem::default_workers_count();
+        std::string output;
+        std::filesystem::path snapshot;
+    };
+
+    struct Result
+    {
+        std::string layout;
+        std::size_t chunk_capacity = 0;
+        std::size_t entities_count = 0;
+        double movement_ns_per_entity = 0.0;
+        double render_ns_per_entity = 0.0;
+        double allocations_per_frame = 0.0;
+        std::optional<double> movement_cache_misses_per_entity;
+        std::optional<double> render_cache_misses_per_entity;
+    };
+
+    // Render system with the renderer replaced by CPU side buffers: does all the per-entity
+    // work of the batched render path except the upload and the draw call.
+    template <typename StorageType>
+    class NullRenderSystem final : public StorageType::SystemType
+    {
+    public:
+        NullRenderSystem()
+        {
+            m_culling.set_view(WorldSize);
+        }
+
+        ComponentAccess access() const override
+        {
+            return {.reads = StorageType::template components_mask<PositionComponent,
+                                                                   PreviousPositionComponent,
+                                                                   SizeComponent,
+                                                                   RenderComponent>()};
+        }
+
+        void update() override
+        {
+            auto &storage = this->storage();
+
+            const std::size_t vertices_count = storage.size() * 4;
+            if (m_vertices.size() < vertices_count)
+            {
+                m_vertices.resize(vertices_count);
+                m_colors.resize(vertices_count);
+                m_colors_version = 0;
+            }
+
+            // Same color reuse as the batched render path, with a single buffer instead of a ring.
+            const std::uint64_t colors_version = storage.template column_version<RenderComponent>();
+            const bool reuse_colors = colors_version != 0 && m_colors_version == colors_version;
+
+            m_culling.begin_frame();
+            const std::size_t count = write_quads(storage,
+                                                  0.5f,
+                                                  std::span(m_vertices),
+                                                  reuse_colors ? std::span<NG::Color>{} : std::span(m_colors),
+                                                  &m_culling);
+
+            const bool all_drawn = count == storage.size();
+            if (reuse_colors && !all_drawn)
+            {
+                m_culling.begin_frame();
+                write_quads(storage, 0.5f, std::span(m_vertices), std::span(m_colors), &m_culling);
+            }
+            m_colors_version = all_drawn ? colors_version : 0;
+        }
+
+    private:
+        ViewCulling m_culling;
+        std::vector<NM::Vector3f> m_vertices;
+        std::vector<NG::Color> m_colors;
+        std::uint64_t m_colors_version = 0;
+    };
+
+    template <typename StorageType>
+    void spawn_entities(StorageType &storage, std::size_t count)
+    {
+        storage.create_entities(count,
+                                [](std::size_t i,
+                                   RenderComponent &r,
+                                   SizeComponent &s,
+                                   PositionComponent &p,
+                                   PreviousPositionComponent &pp,
+                                   MovementComponent &m)
+                                {
+                                    CounterRandom random(42, i);
+
+                                    r.color = NG::Colorf{random.uniform(0.2f, 1.0f),
+                                                         random.uniform(0.2f, 1.0f),
+                                                         random.uniform(0.2f, 1.0f),
+                                                         1.0f};
+                                    s.size = NM::Vector2i{random.uniform(10, 20), random.uniform(10, 20)};
+                                    p.pos = NM::Vector2i{random.uniform(100, 200), random.uniform(100, 200)};
+                                    pp.pos = p.pos;
+                                    m.offset = NM::Vector2i{random.uniform(-10, 10), random.uniform(-10, 10)};
+                                });
+    }
+
+    double median(std::vector<double> values)
+    {
+        const auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        std::nth_element(values.begin(), middle, values.end());
+        return *middle;
+    }
+
+    template <std::size_t ChunkSize>
+    Result run_case(const Config &config,
+                    std::size_t entities_count,
+                    JobSystem &jobs,
+                    const CacheMissCounter &cache_misses)
+    {
+        using StorageType = BasicECSType<ChunkSize>;
+
+        auto storage = std::make_unique<StorageType>();
+        storage->set_job_system(&jobs);
+        storage->add_system(std::make_unique<BasicMovementSystem<StorageType>>(WorldSize), SystemStage::Simulation);
+        storage->add_system(std::make_unique<NullRenderSystem<StorageType>>(), SystemStage::Render);
+
+        if (config.snapshot.empty())
+        {
+            spawn_entities(*storage, entities_count);
+        }
+        else
+        {
+            load_snapshot(*storage, config.snapshot);
+            entities_count = storage->size();
+        }
+
+        for (std::size_t i = 0; i < config.warmup_frames_count; ++i)
+        {
+            storage->update(SystemStage::Simulation);
+            storage->update(SystemStage::Render);
+        }
+
+        std::vector<double> movement_ns;
+        std::vector<double> render_ns;
+        movement_ns.reserve(config.frames_count);
+        render_ns.reserve(config.frames_count);
+
+        std::uint64_t movement_misses = 0;
+        std::uint64_t render_misses = 0;
+
+        using Clock = std::chrono::steady_clock;
+        const std::uint64_t allocations_before = allocations_count.load();
+
+        for (std::size_t i = 0; i < config.frames_count; ++i)
+        {
+            const std::uint64_t misses_0 = cache_misses.read();
+            const auto t0 = Clock::now();
+            storage->update(SystemStage::Simulation);
+            const auto t1 = Clock::now();
+            const std::uint64_t misses_1 = cache_misses.read();
+            storage->update(SystemStage::Render);
+            const auto t2 = Clock::now();
+            const std::uint64_t misses_2 = cache_misses.read();
+
+            movement_ns.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+            render_ns.push_back(std::chrono::duration<double, std::nano>(t2 - t1).count());
+            movement_misses += misses_1 - misses_0;
+            render_misses += misses_2 - misses_1;
+        }
+
+        const std::uint64_t allocations_after = allocations_count.load();
+
+        const auto entities = static_cast<double>(std::max<std::size_t>(entities_count, 1));
+        const auto frames = static_cast<double>(std::max<std::size_t>(config.frames_count, 1));
+
+        Result result;
+        result.layout = "chunk_" + std::to_string(ChunkSize / 1024) + "k";
+        result.chunk_capacity = StorageType::ChunkCapacity;
+        result.entities_count = entities_count;
+        result.movement_ns_per_entity = median(movement_ns) / entities;
+        result.render_ns_per_entity = median(render_ns) / entities;
+        result.allocations_per_frame = static_cast<double>(allocations_after - allocations_before) / frames;
+
+        if (cache_misses.available())
+        {
+            result.movement_cache_misses_per_entity = static_cast<double>(movement_misses) / frames / entities;
+            result.render_cache_misses_per_entity = static_cast<double>(render_misses) / frames / entities;
+        }
+
+        return result;
+    }
+
+    std::string to_json(const std::optional<double> &value)
+    {
+        return value ? std::to_string(*value) : "null";
+    }
+
+    void write_json(std::ostream &os, const Config &config, const JobSystem &jobs, const std::vector<Result> &results)
+    {
+        os << "{\n";
+        os << "  \"kernel\": \"" << movement_kernel_name() << "\",\n";
+        os << "  \"workers\": " << jobs.workers_count() << ",\n";
+        os << "  \"frames\": " << config.frames_count << ",\n";
+        os << "  \"results\": [\n";
+
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result &r = results[i];
+            os << "    {\"layout\": \"" << r.layout << "\", "
+               << "\"chunk_capacity\": " << r.chunk_capacity << ", "
+               << "\"entities\": " << r.entities_count << ", "
+               << "\"movement_ns_per_entity\": " << r.movement_ns_per_entity << ", "
+               << "\"render_ns_per_entity\": " << r.render_ns_per_entity << ", "
+               << "\"allocations_per_frame\": " << r.allocations_per_frame << ", "
+               << "\"movement_cache_misses_per_entity\": " << to_json(r.movement_cache_misses_per_entity) << ", "
+               << "\"render_cache_misses_per_entity\": " << to_json(r.render_cache_misses_per_entity) << "}"
+               << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        os << "  ]\n";
+        os << "}\n";
+    }
+
+    constexpr const char *Usage = "Usage: life_bench [--entities 10000,100000] [--frames 200] [--warmup 20] "
+                                  "[--workers 7] [--snapshot life.snapshot] [--output results.json]";
+
+    // True if the whole text is a number and it was stored into value.
+    bool parse_number(std::string_view text, std::size_t &value)
+    {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    // Comma separated list of non-zero counts, nothing when any item is not one.
+    std::optional<std::vector<std::size_t>> parse_counts(std::string_view text)
+    {
+        std::vector<std::size_t> counts;
+        while (true)
+        {
+            const std::size_t comma = text.find(',');
+            std::size_t count = 0;
+            if (!parse_number(text.substr(0, comma), count) || count == 0)
+            {
+                return std::nullopt;
+            }
+            counts.push_back(count);
+
+            if (comma == std::string_view::npos)
+            {
+                return counts;
+            }
+            text.remove_prefix(comma + 1);
+        }
+    }
+
+    // Nothing when an option is unknown, has no value or its value is invalid, the error is
+    // printed then.
+    std::optional<Config> parse_config(int argc, char *argv[])
+    {
+        Config config;
+        for (int i = 1; i < argc; i += 2)
+        {
+            const std::string_view option = argv[i];
+            if (i + 1 == argc)
+            {
+                std::cerr << "Missing value of " << option << std::endl;
+                return std::nullopt;
+            }
+            const std::string_view value = argv[i + 1];
+
+            bool valid = true;
+            if (option == "--entities")
+            {
+                auto counts = parse_counts(value);
+                valid = counts.has_value();
+                if (valid)
+                {
+                    config.entities_counts = std::move(*counts);
+                }
+            }
+            else if (option == "--frames")
+            {
+                valid = parse_number(value, config.frames_count) && config.frames_count > 0;
+            }
+            else if (option == "--warmup")
+            {
+                valid = parse_number(value, config.warmup_frames_count);
+            }
+            else if (option == "--workers")
+            {
+                valid = parse_number(value, config.workers_count);
+            }
+            else if (option == "--snapshot")
+            {
+                config.snapshot = value;
+            }
+            else if (option == "--output")
+            {
+                config.output = value;
+            }
+            else
+            {
+                std::cerr << "Unknown option: " << option << std::endl;
+                return std::nullopt;
+            }
+
+            if (!valid)
+            {
+                std::cerr << "Invalid value of " << option << ": " << value << std::endl;
+                return std::nullopt;
+            }
+        }
+        return config;
+    }
+}
+
+// Usage: life_bench [--entities 10000,100000] [--frames 200] [--warmup 20] [--workers 7]
+//                   [--snapshot life.snapshot] [--output results.json]
+// With a snapshot every case starts from the saved state and --entities is ignored.
+// Results are written as JSON to the output file or to stdout. Counts of entities and frames
+// must be positive. Returns 1 on invalid arguments and when the bench or the output fails.
+int main(int argc, char *argv[])
+{
+    neutrino::log::set_logger(std::make_unique<NL::StreamLogger>(std::cerr));
+
+    const std::optional<Config> parsed = parse_config(argc, argv);
+    if (!parsed)
+    {
+        std::cerr << Usage << std::endl;
+        return 1;
+    }
+    const Config &config = *parsed;
+
+    // Opened before the job system, so the counter is inherited by the worker threads.
+    const CacheMissCounter cache_misses;
+    if (!cache_misses.available())
+    {
+        NL::info("Bench") << "Cache miss counter is not available";
+    }
+
+    JobSystem jobs(config.workers_count);
+    NL::info("Bench") << "Movement kernel: " << movement_kernel_name() << ", workers: " << jobs.workers_count();
+
+    std::vector<Result> results;
+    const std::vector<std::size_t> counts =
+        config.snapshot.empty() ? config.entities_counts : std::vector<std::size_t>{0};
+
+    try
+    {
+        for (const std::size_t count : counts)
+        {
+            results.push_back(run_case<4 * 1024>(config, count, jobs, cache_misses));
+            results.push_back(run_case<DefaultChunkSize>(config, count, jobs, cache_misses));
+            results.push_back(run_case<64 * 1024>(config, count, jobs, cache_misses));
+
+            NL::info("Bench") << results.back().entities_count << " entities done";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        NL::error("Bench") << e.what();
+        return 1;
+    }
+
+    if (config.output.empty())
+    {
+        write_json(std::cout, config, jobs, results);
+        return std::cout ? 0 : 1;
+    }
+
+    std::ofstream file(config.output);
+    if (!file)
+    {
+        NL::error("Bench") << "Can't create " << config.output;
+        return 1;
+    }
+
+    write_json(file, config, jobs, results);
+    file.close();
+    if (!file)
+    {
+        NL::error("Bench") << "Can't write " << config.output;
+        return 1;
+    }
+
+    return 0;
+}
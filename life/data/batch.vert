@@ -0,0 +1,14 @@
+#version 330 core
+
+layout(location = 0) in vec3 vertex;
+layout(location = 3) in vec4 color;
+
+uniform mat4 projectionMatrix;
+
+out vec4 fragColor;
+
+void main()
+{
+    gl_Position = projectionMatrix * vec4(vertex, 1.0);
+    fragColor = color;
+}
@@ -0,0 +1,69 @@
+#version 330 core
+
+// xy - position at tick zero, z - quad corner index
+layout(location = 0) in vec3 vertex;
+// xy - offset per tick
+layout(location = 1) in vec3 normal;
+// xy - size
+layout(location = 2) in vec3 tangent;
+layout(location = 3) in vec4 color;
+
+uniform vec2 bounds;
+uniform float ticks;
+
+uniform mat4 projectionMatrix;
+
+out vec4 fragColor;
+
+const vec2 corners[4] = vec2[4](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+
+// Position along one axis after reflecting from the walls of [0, bound], see reflect_motion()
+// on the CPU side for the math.
+float reflect_motion(float start, float offset, float size, float bound)
+{
+    float speed = abs(offset);
+    if (speed == 0.0)
+    {
+        return start;
+    }
+
+    float half_size = floor(size * 0.5);
+    float low = half_size;
+    float high = bound - half_size;
+
+    bool turning = start < low || start > high;
+    float next = turning ? start - offset : start + offset;
+
+    float first;
+    float last;
+    if (turning && (next < low || next > high))
+    {
+        first = min(start, next);
+        last = max(start, next);
+    }
+    else
+    {
+        first = start - speed * (floor((start - low) / speed) + 1.0);
+        last = start + speed * (floor((high - start) / speed) + 1.0);
+    }
+
+    float range = last - first;
+    float period = 2.0 * range;
+
+    bool forward = (turning ? -offset : offset) > 0.0;
+    float phase = forward ? start - first : period - (start - first);
+    float t = mod(phase + speed * ticks, period);
+
+    return first + min(t, period - t);
+}
+
+void main()
+{
+    vec2 size = tangent.xy;
+    vec2 center = vec2(reflect_motion(vertex.x, normal.x, size.x, bounds.x),
+                       reflect_motion(vertex.y, normal.y, size.y, bounds.y));
+    vec2 position = center + corners[int(vertex.z)] * size;
+
+    gl_Position = projectionMatrix * vec4(position, 0.0, 1.0);
+    fragColor = color;
+}
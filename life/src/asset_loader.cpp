@@ -0,0 +1,84 @@
+#include "asset_loader.hpp"
+
+#include "tracer.hpp"
+
+AssetLoader::AssetLoader()
+    : m_thread(&AssetLoader::run, this)
+{
+}
+
+AssetLoader::~AssetLoader()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+std::size_t AssetLoader::process_uploads(std::chrono::steady_clock::duration budget)
+{
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+
+    std::size_t count = 0;
+    do
+    {
+        Task task;
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_uploads.empty())
+            {
+                break;
+            }
+            task = std::move(m_uploads.front());
+            m_uploads.pop_front();
+        }
+
+        {
+            Tracer::Scope trace("asset upload");
+            task();
+        }
+        ++count;
+    } while (std::chrono::steady_clock::now() < deadline);
+
+    return count;
+}
+
+void AssetLoader::push_read(Task task)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_reads.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void AssetLoader::push_upload(Task task)
+{
+    std::lock_guard lock(m_mutex);
+    m_uploads.push_back(std::move(task));
+}
+
+void AssetLoader::run()
+{
+    Tracer::instance().set_thread_name("asset loader");
+
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || !m_reads.empty(); });
+            if (m_stop)
+            {
+                return;
+            }
+            task = std::move(m_reads.front());
+            m_reads.pop_front();
+        }
+
+        Tracer::Scope trace("asset read");
+        task();
+    }
+}
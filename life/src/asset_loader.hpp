@@ -0,0 +1,116 @@
+#ifndef LIFE_ASSET_LOADER_HPP
+#define LIFE_ASSET_LOADER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Loads assets in two steps: reading on a background thread, uploading on the main thread.
+//
+// Reading (files, decoding, building meshes) must not touch the renderer, its result is
+// handed to the upload step, which runs in process_uploads() on the thread that owns the
+// graphics context. The app keeps rendering frames while assets load, and every load has a
+// future that becomes ready once its upload has run.
+class AssetLoader
+{
+public:
+    using Task = std::function<void()>;
+
+    AssetLoader();
+
+    // Loads that were not read yet are dropped, their futures report a broken promise.
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Queues read() for the loader thread and upload(result) for the main thread. Exceptions
+    // thrown by either step are stored in the future.
+    template <typename Read, typename Upload>
+    std::future<void> load(Read read, Upload upload);
+
+    // Runs queued uploads until the budget is spent, at least one when any is queued, so a
+    // burst of finished loads is spread over several frames. Returns the number of uploads run.
+    std::size_t process_uploads(std::chrono::steady_clock::duration budget);
+
+private:
+    void push_read(Task task);
+    void push_upload(Task task);
+    void run();
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Task> m_reads;
+    std::deque<Task> m_uploads;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+template <typename Read, typename Upload>
+std::future<void> AssetLoader::load(Read read, Upload upload)
+{
+    using Result = std::invoke_result_t<Read&>;
+
+    // Tasks are std::function, so the move-only promise and result are shared.
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+
+    push_read(
+        [this, promise, read = std::move(read), upload = std::move(upload)]() mutable
+        {
+            try
+            {
+                if constexpr (std::is_void_v<Result>)
+                {
+                    read();
+                    push_upload(
+                        [promise, upload = std::move(upload)]() mutable
+                        {
+                            try
+                            {
+                                upload();
+                                promise->set_value();
+                            }
+                            catch (...)
+                            {
+                                promise->set_exception(std::current_exception());
+                            }
+                        });
+                }
+                else
+                {
+                    auto result = std::make_shared<Result>(read());
+                    push_upload(
+                        [promise, result, upload = std::move(upload)]() mutable
+                        {
+                            try
+                            {
+                                upload(std::move(*result));
+                                promise->set_value();
+                            }
+                            catch (...)
+                            {
+                                promise->set_exception(std::current_exception());
+                            }
+                        });
+                }
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        });
+
+    return future;
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef LIFE_COLLISION_SYSTEM_HPP
+#define LIFE_COLLISION_SYSTEM_HPP
+
+#include <cstdlib>
+
+#include <common/size.hpp>
+
+#include "components.hpp"
+#include "ecs.hpp"
+#include "spatial_grid.hpp"
+
+// Pushes overlapping entities apart: an entity that overlaps others turns its movement away
+// from them. Neighbors come from a spatial grid rebuilt every update, so the cost stays
+// linear in the entity count while the density is bounded.
+template <typename StorageType>
+class BasicCollisionSystem : public StorageType::SystemType
+{
+public:
+    static constexpr std::size_t EntriesPerJob = 2048;
+
+    BasicCollisionSystem(neutrino::Size size)
+        : m_grid(size)
+    {
+    }
+
+    ComponentAccess access() const override
+    {
+        return {.reads = StorageType::template components_mask<PositionComponent, SizeComponent>(),
+                .writes = StorageType::template components_mask<MovementComponent>()};
+    }
+
+    void update() override
+    {
+        auto &storage = this->storage();
+        m_grid.rebuild(storage, storage.job_system());
+
+        // Entries are walked in grid order, so neighboring queries hit the same cells. Every
+        // entity only writes its own movement, the jobs never write the same component.
+        const auto job = [this, &storage](std::size_t begin, std::size_t end)
+        {
+            const auto entries = m_grid.entries();
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                resolve(storage, entries[i]);
+            }
+        };
+
+        JobSystem *jobs = storage.job_system();
+        if (jobs == nullptr)
+        {
+            job(0, m_grid.entries().size());
+        }
+        else
+        {
+            jobs->parallel_for(m_grid.entries().size(), EntriesPerJob, job);
+        }
+
+        // Writes are scattered over the storage, every chunk counts as changed.
+        for (std::size_t c = 0; c < storage.chunks_count(); ++c)
+        {
+            storage.template mark_changed<MovementComponent>(storage.chunk(c));
+        }
+    }
+
+    const SpatialGrid &grid() const
+    {
+        return m_grid;
+    }
+
+private:
+    void resolve(StorageType &storage, const SpatialGrid::Entry &entry) const
+    {
+        // Doubled centers keep the math in integers.
+        const int center_x = entry.min.x + entry.max.x;
+        const int center_y = entry.min.y + entry.max.y;
+
+        int push_x = 0;
+        int push_y = 0;
+        m_grid.query(entry.min,
+                     entry.max,
+                     [&](const SpatialGrid::Entry &other)
+                     {
+                         if (other.index != entry.index)
+                         {
+                             push_x += center_x - (other.min.x + other.max.x);
+                             push_y += center_y - (other.min.y + other.max.y);
+                         }
+                     });
+
+        auto &offset = storage.template component<MovementComponent>(entry.index).offset;
+        if (push_x != 0)
+        {
+            offset.x = push_x > 0 ? std::abs(offset.x) : -std::abs(offset.x);
+        }
+        if (push_y != 0)
+        {
+            offset.y = push_y > 0 ? std::abs(offset.y) : -std::abs(offset.y);
+        }
+    }
+
+    SpatialGrid m_grid;
+};
+
+using CollisionSystem = BasicCollisionSystem<ECSType>;
+
+#endif
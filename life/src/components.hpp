@@ -0,0 +1,47 @@
+#ifndef LIFE_COMPONENTS_HPP
+#define LIFE_COMPONENTS_HPP
+
+#include <cstddef>
+
+#include <graphics/color.hpp>
+#include <math/math.hpp>
+
+#include "ecs.hpp"
+
+struct RenderComponent
+{
+    neutrino::graphics::Colorf color;
+};
+
+struct SizeComponent
+{
+    neutrino::math::Vector2i size;
+};
+
+struct PositionComponent
+{
+    neutrino::math::Vector2i pos;
+};
+
+// Position before the last simulation step, used to interpolate between simulation states.
+struct PreviousPositionComponent
+{
+    neutrino::math::Vector2i pos;
+};
+
+struct MovementComponent
+{
+    neutrino::math::Vector2i offset;
+};
+
+template <std::size_t ChunkSize>
+using BasicECSType = BasicECS<ChunkSize,
+                              RenderComponent,
+                              SizeComponent,
+                              PositionComponent,
+                              PreviousPositionComponent,
+                              MovementComponent>;
+
+using ECSType = BasicECSType<DefaultChunkSize>;
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef LIFE_COUNTER_RANDOM_HPP
+#define LIFE_COUNTER_RANDOM_HPP
+
+#include <cstdint>
+
+// Counter-based random numbers: the sequence is a pure function of (seed, counter), so every
+// entity can get its own generator from its index and bulk initialization may be split
+// between threads in any way without changing the result. Based on the splitmix64 mixer.
+class CounterRandom
+{
+public:
+    CounterRandom(std::uint64_t seed, std::uint64_t counter)
+        : m_state(seed ^ (counter * 0xD6E8FEB86659FD93ULL))
+    {
+    }
+
+    std::uint64_t next()
+    {
+        std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [min, max], multiply-shift range reduction.
+    int uniform(int min, int max)
+    {
+        const auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min + 1);
+        return static_cast<int>(static_cast<std::int64_t>(min) +
+                                static_cast<std::int64_t>(((next() >> 32) * range) >> 32));
+    }
+
+    // Uniform in [min, max).
+    float uniform(float min, float max)
+    {
+        const float unit = static_cast<float>(next() >> 40) * (1.0f / 16777216.0f);
+        return min + (max - min) * unit;
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+#endif
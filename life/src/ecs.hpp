@@ -0,0 +1,840 @@
+#ifndef LIFE_ECS_HPP
+#define LIFE_ECS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include "frame_profiler.hpp"
+#include "job_system.hpp"
+#include "tracer.hpp"
+
+inline constexpr std::size_t CacheLineSize = 64;
+inline constexpr std::size_t DefaultChunkSize = 16 * 1024;
+
+// Compile-time list of component types. Every type maps to its position in the list,
+// which is the column of the type in a chunk and its bit in ComponentAccess masks.
+template <typename... Types>
+struct TypeList
+{
+    static constexpr std::size_t size = sizeof...(Types);
+
+    template <typename T>
+    static constexpr std::size_t count = (std::size_t{std::is_same_v<T, Types>} + ... + 0);
+
+    template <typename T>
+    static constexpr bool contains = count<T> != 0;
+
+    // Single expansion over the list per lookup, no recursive instantiations.
+    template <typename T>
+    static constexpr std::size_t index_of = []()
+    {
+        constexpr bool matches[] = {std::is_same_v<T, Types>..., false};
+
+        std::size_t index = 0;
+        while (index < sizeof...(Types) && !matches[index])
+        {
+            ++index;
+        }
+        return index;
+    }();
+};
+
+template <typename List, typename T>
+inline constexpr std::size_t type_index_v = List::template index_of<T>;
+
+template <typename... Types>
+inline constexpr bool unique_types_v = ((TypeList<Types...>::template count<Types> == 1) && ...);
+
+// Number of entities that fit into one chunk, rounded down to a multiple of 16
+// so vectorized kernels never have to deal with a partial block in a full chunk.
+template <std::size_t ChunkSize, typename... Types>
+inline constexpr std::size_t chunk_capacity_v = (ChunkSize / (sizeof(Types) + ...)) / 16 * 16;
+
+// Fixed-size block of entities. Every component type has its own cache-line aligned
+// array inside the chunk, so systems iterate contiguous memory per component.
+template <std::size_t ChunkSize, typename... Types>
+class BasicChunk
+{
+public:
+    using Components = TypeList<Types...>;
+
+    static constexpr std::size_t Capacity = chunk_capacity_v<ChunkSize, Types...>;
+
+    static_assert(Capacity > 0, "Components are too big for a chunk");
+    static_assert(unique_types_v<Types...>, "Component types must be unique");
+
+    template <typename ComponentType>
+    ComponentType *data()
+    {
+        static_assert(Components::template contains<ComponentType>, "Component type is not in the chunk");
+        return std::get<type_index_v<Components, ComponentType>>(m_columns).items.data();
+    }
+
+    template <typename ComponentType>
+    const ComponentType *data() const
+    {
+        static_assert(Components::template contains<ComponentType>, "Component type is not in the chunk");
+        return std::get<type_index_v<Components, ComponentType>>(m_columns).items.data();
+    }
+
+    template <typename ComponentType>
+    std::span<ComponentType> components()
+    {
+        return {data<ComponentType>(), m_size};
+    }
+
+    template <typename ComponentType>
+    std::span<const ComponentType> components() const
+    {
+        return {data<ComponentType>(), m_size};
+    }
+
+    void push_back(const Types &...components)
+    {
+        ((data<Types>()[m_size] = components), ...);
+        ++m_size;
+    }
+
+    void pop_back()
+    {
+        --m_size;
+    }
+
+    // Entities in [size(), new_size) keep whatever their columns hold, the caller writes them.
+    void resize(std::size_t new_size)
+    {
+        m_size = new_size;
+    }
+
+    // Copies all components of entity from other chunk into slot index of this chunk.
+    void copy_entity(std::size_t index, const BasicChunk &other, std::size_t other_index)
+    {
+        ((data<Types>()[index] = other.data<Types>()[other_index]), ...);
+    }
+
+    void clear()
+    {
+        m_size = 0;
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    bool full() const
+    {
+        return m_size == Capacity;
+    }
+
+    // Version of the last change of the component column, 0 when it never changed.
+    template <typename ComponentType>
+    std::uint64_t version() const
+    {
+        static_assert(Components::template contains<ComponentType>, "Component type is not in the chunk");
+        return m_versions[type_index_v<Components, ComponentType>];
+    }
+
+    template <typename... ComponentTypes>
+    void set_version(std::uint64_t version)
+    {
+        ((m_versions[type_index_v<Components, ComponentTypes>] = version), ...);
+    }
+
+private:
+    template <typename T>
+    struct alignas(CacheLineSize) Column
+    {
+        std::array<T, Capacity> items;
+    };
+
+    std::tuple<Column<Types>...> m_columns;
+    std::size_t m_size = 0;
+    std::array<std::uint64_t, sizeof...(Types)> m_versions{};
+};
+
+template <typename... Types>
+using Chunk = BasicChunk<DefaultChunkSize, Types...>;
+
+// Component types a system reads and writes, one bit per component type.
+// Systems without conflicting access are run in parallel.
+struct ComponentAccess
+{
+    std::uint64_t reads = 0;
+    std::uint64_t writes = 0;
+    bool main_thread = false;
+
+    static constexpr ComponentAccess exclusive()
+    {
+        return {.reads = ~std::uint64_t{0}, .writes = ~std::uint64_t{0}, .main_thread = true};
+    }
+
+    constexpr bool conflicts(const ComponentAccess &other) const
+    {
+        return (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+    }
+};
+
+template <typename ECSType>
+class System
+{
+public:
+    virtual ~System() = default;
+
+    void set_storage(ECSType *storage)
+    {
+        m_storage = storage;
+    }
+
+    const ECSType &storage() const
+    {
+        return *m_storage;
+    }
+
+    ECSType &storage()
+    {
+        return *m_storage;
+    }
+
+    void set_enabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    bool enabled() const
+    {
+        return m_enabled;
+    }
+
+    // Systems that do not override it are run alone on the main thread.
+    virtual ComponentAccess access() const
+    {
+        return ComponentAccess::exclusive();
+    }
+
+    // Name of the profiler and trace scopes the updates are timed in.
+    virtual std::string name() const
+    {
+        return type_name(typeid(*this));
+    }
+
+    virtual void update() = 0;
+
+private:
+    ECSType *m_storage;
+    bool m_enabled = true;
+};
+
+template <typename ChunkType, typename... ComponentTypes>
+class ComponentsView
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::tuple<ComponentTypes &...>;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        Iterator(std::unique_ptr<ChunkType> *chunk, std::unique_ptr<ChunkType> *chunks_end)
+            : m_chunk(chunk), m_chunks_end(chunks_end)
+        {
+            skip_empty_chunks();
+        }
+
+        value_type operator*() const
+        {
+            ChunkType &chunk = **m_chunk;
+            return value_type(chunk.template data<std::remove_const_t<ComponentTypes>>()[m_index]...);
+        }
+
+        Iterator &operator++()
+        {
+            if (++m_index == (*m_chunk)->size())
+            {
+                ++m_chunk;
+                m_index = 0;
+                skip_empty_chunks();
+            }
+
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return m_chunk == other.m_chunk && m_index == other.m_index;
+        }
+
+    private:
+        void skip_empty_chunks()
+        {
+            while (m_chunk != m_chunks_end && (*m_chunk)->size() == 0)
+            {
+                ++m_chunk;
+            }
+        }
+
+        std::unique_ptr<ChunkType> *m_chunk = nullptr;
+        std::unique_ptr<ChunkType> *m_chunks_end = nullptr;
+        std::size_t m_index = 0;
+    };
+
+    ComponentsView(std::unique_ptr<ChunkType> *chunks_begin, std::unique_ptr<ChunkType> *chunks_end)
+        : m_chunks_begin(chunks_begin), m_chunks_end(chunks_end)
+    {
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(m_chunks_begin, m_chunks_end);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(m_chunks_end, m_chunks_end);
+    }
+
+private:
+    std::unique_ptr<ChunkType> *m_chunks_begin;
+    std::unique_ptr<ChunkType> *m_chunks_end;
+};
+
+// Simulation systems run at a fixed rate, render systems once per frame.
+enum class SystemStage
+{
+    Simulation,
+    Render,
+};
+
+// Handle of an entity. Slots of destroyed entities are reused, the generation
+// tells a live entity from a stale handle to an older entity in the same slot.
+struct Entity
+{
+    static constexpr std::uint32_t InvalidIndex = ~std::uint32_t{0};
+
+    std::uint32_t index = InvalidIndex;
+    std::uint32_t generation = 0;
+
+    bool operator==(const Entity &) const = default;
+};
+
+// Chunk size is a parameter so storage layouts can be compared, everything else uses ECS.
+template <std::size_t ChunkSize, typename... Types>
+class BasicECS
+{
+public:
+    using ChunkType = BasicChunk<ChunkSize, Types...>;
+    using SystemType = System<BasicECS<ChunkSize, Types...>>;
+
+    static constexpr std::size_t ChunkCapacity = ChunkType::Capacity;
+
+    static_assert(sizeof...(Types) <= 64, "ComponentAccess supports up to 64 component types");
+
+    template <typename... ComponentTypes>
+    static constexpr std::uint64_t components_mask()
+    {
+        static_assert((ChunkType::Components::template contains<ComponentTypes> && ...),
+                      "Component type is not in the storage");
+        return ((std::uint64_t{1} << type_index_v<typename ChunkType::Components, ComponentTypes>) | ... | 0);
+    }
+
+    // Chunks are processed with the job system when it is set, otherwise on the calling thread.
+    void set_job_system(JobSystem *jobs)
+    {
+        m_jobs = jobs;
+    }
+
+    JobSystem *job_system() const
+    {
+        return m_jobs;
+    }
+
+    // While the profiler is enabled every system update is timed in a scope named after the system,
+    // nested in the scope that is open when update() is called.
+    void set_profiler(FrameProfiler *profiler)
+    {
+        m_profiler = profiler;
+    }
+
+    // Change tracking: a change of a component column in a chunk stamps the column with a new
+    // version from a storage-wide counter, so a reader that remembers version() can tell later
+    // which chunks changed since. Creating and destroying entities stamps all columns of the
+    // chunks it touches, systems stamp the columns they write with mark_changed().
+    std::uint64_t version() const
+    {
+        return m_version.load(std::memory_order_relaxed);
+    }
+
+    // Safe to call from jobs working on different chunks.
+    template <typename... ComponentTypes>
+    void mark_changed(ChunkType &chunk)
+    {
+        chunk.template set_version<ComponentTypes...>(m_version.fetch_add(1, std::memory_order_relaxed) + 1);
+    }
+
+    // Latest change of the component in any chunk holding entities, 0 when there are none.
+    template <typename ComponentType>
+    std::uint64_t column_version() const
+    {
+        std::uint64_t version = 0;
+        for (std::size_t c = 0; c < chunks_count(); ++c)
+        {
+            version = std::max(version, m_chunks[c]->template version<ComponentType>());
+        }
+        return version;
+    }
+
+    // Entities are kept densely packed: dense index i lives in chunk i / ChunkCapacity.
+    Entity create_entity(const Types &...components)
+    {
+        const std::size_t chunk_index = m_size / ChunkCapacity;
+        if (chunk_index == m_chunks.size())
+        {
+            m_chunks.push_back(std::make_unique<ChunkType>());
+        }
+
+        m_chunks[chunk_index]->push_back(components...);
+        mark_changed<Types...>(*m_chunks[chunk_index]);
+
+        std::uint32_t slot_index = 0;
+        if (m_free_slots.empty())
+        {
+            slot_index = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.push_back(Slot{});
+        }
+        else
+        {
+            slot_index = m_free_slots.back();
+            m_free_slots.pop_back();
+        }
+
+        Slot &slot = m_slots[slot_index];
+        slot.dense_index = static_cast<std::uint32_t>(m_size);
+
+        if (m_dense_slots.size() == m_size)
+        {
+            m_dense_slots.push_back(slot_index);
+        }
+        else
+        {
+            m_dense_slots[m_size] = slot_index;
+        }
+
+        ++m_size;
+
+        return Entity{.index = slot_index, .generation = slot.generation};
+    }
+
+    // Creates count entities at once, generator(i, components...) fills the components of the
+    // i-th new entity in place. Slots are assigned up front and chunks are filled in parallel,
+    // so the generator is called concurrently and should only depend on i. Entity handles are
+    // written to handles when it is not empty.
+    template <typename Generator>
+    void create_entities(std::size_t count, Generator &&generator, std::span<Entity> handles = {})
+    {
+        const std::size_t first = m_size;
+        reserve(first + count);
+
+        if (m_dense_slots.size() < first + count)
+        {
+            m_dense_slots.resize(first + count);
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::uint32_t slot_index = 0;
+            if (m_free_slots.empty())
+            {
+                slot_index = static_cast<std::uint32_t>(m_slots.size());
+                m_slots.push_back(Slot{});
+            }
+            else
+            {
+                slot_index = m_free_slots.back();
+                m_free_slots.pop_back();
+            }
+
+            Slot &slot = m_slots[slot_index];
+            slot.dense_index = static_cast<std::uint32_t>(first + i);
+            m_dense_slots[first + i] = slot_index;
+
+            if (!handles.empty())
+            {
+                handles[i] = Entity{.index = slot_index, .generation = slot.generation};
+            }
+        }
+
+        const std::size_t first_chunk = first / ChunkCapacity;
+        const std::size_t end_chunk = (first + count + ChunkCapacity - 1) / ChunkCapacity;
+
+        const auto fill = [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t c = first_chunk + begin; c < first_chunk + end; ++c)
+            {
+                ChunkType &chunk = *m_chunks[c];
+                const std::size_t chunk_first = c * ChunkCapacity;
+                const std::size_t from = std::max(first, chunk_first) - chunk_first;
+                const std::size_t to = std::min(first + count, chunk_first + ChunkCapacity) - chunk_first;
+
+                for (std::size_t j = from; j < to; ++j)
+                {
+                    generator(chunk_first + j - first, chunk.template data<Types>()[j]...);
+                }
+
+                chunk.resize(to);
+                mark_changed<Types...>(chunk);
+            }
+        };
+
+        if (m_jobs == nullptr)
+        {
+            fill(0, end_chunk - first_chunk);
+        }
+        else
+        {
+            m_jobs->parallel_for(end_chunk - first_chunk, 1, fill);
+        }
+
+        m_size += count;
+    }
+
+    // The last entity is moved into the place of the destroyed one, so dense indices
+    // of other entities may change. Chunk memory is kept for future entities.
+    void destroy_entity(Entity entity)
+    {
+        if (!alive(entity))
+        {
+            return;
+        }
+
+        Slot &slot = m_slots[entity.index];
+        const std::size_t dense_index = slot.dense_index;
+        const std::size_t last_index = m_size - 1;
+
+        if (dense_index != last_index)
+        {
+            m_chunks[dense_index / ChunkCapacity]->copy_entity(dense_index % ChunkCapacity,
+                                                               *m_chunks[last_index / ChunkCapacity],
+                                                               last_index % ChunkCapacity);
+            mark_changed<Types...>(*m_chunks[dense_index / ChunkCapacity]);
+
+            const std::uint32_t moved_slot = m_dense_slots[last_index];
+            m_dense_slots[dense_index] = moved_slot;
+            m_slots[moved_slot].dense_index = static_cast<std::uint32_t>(dense_index);
+        }
+
+        m_chunks[last_index / ChunkCapacity]->pop_back();
+        mark_changed<Types...>(*m_chunks[last_index / ChunkCapacity]);
+        --m_size;
+
+        slot.dense_index = Entity::InvalidIndex;
+        ++slot.generation;
+        m_free_slots.push_back(entity.index);
+    }
+
+    bool alive(Entity entity) const
+    {
+        return entity.index < m_slots.size() && m_slots[entity.index].generation == entity.generation &&
+               m_slots[entity.index].dense_index != Entity::InvalidIndex;
+    }
+
+    // Current dense index of a live entity.
+    std::size_t index_of(Entity entity) const
+    {
+        return m_slots[entity.index].dense_index;
+    }
+
+    // Allocates storage up front, so creating up to count entities never allocates chunks.
+    void reserve(std::size_t count)
+    {
+        const std::size_t chunks_count = (count + ChunkCapacity - 1) / ChunkCapacity;
+        while (m_chunks.size() < chunks_count)
+        {
+            m_chunks.push_back(std::make_unique<ChunkType>());
+        }
+
+        m_slots.reserve(count);
+        m_dense_slots.reserve(count);
+        m_free_slots.reserve(count);
+    }
+
+    // Destroys all entities, handles issued before become stale.
+    void clear()
+    {
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            const std::uint32_t slot_index = m_dense_slots[i];
+            m_slots[slot_index].dense_index = Entity::InvalidIndex;
+            ++m_slots[slot_index].generation;
+            m_free_slots.push_back(slot_index);
+        }
+
+        for (auto &chunk : m_chunks)
+        {
+            chunk->clear();
+        }
+
+        m_size = 0;
+    }
+
+    void add_system(std::unique_ptr<SystemType> system, SystemStage stage = SystemStage::Simulation)
+    {
+        system->set_storage(this);
+
+        Stage &s = m_stages[static_cast<std::size_t>(stage)];
+        s.systems.push_back(std::move(system));
+        s.schedule.clear();
+        s.scopes_resolved = false;
+    }
+
+    // Number of simulation stage updates done so far.
+    std::uint64_t ticks() const
+    {
+        return m_ticks;
+    }
+
+    template <typename ComponentType>
+    const ComponentType &component(std::size_t index) const
+    {
+        return m_chunks[index / ChunkCapacity]->template data<ComponentType>()[index % ChunkCapacity];
+    }
+
+    template <typename ComponentType>
+    ComponentType &component(std::size_t index)
+    {
+        return m_chunks[index / ChunkCapacity]->template data<ComponentType>()[index % ChunkCapacity];
+    }
+
+    template <typename ComponentType>
+    ComponentType &component(Entity entity)
+    {
+        return component<ComponentType>(index_of(entity));
+    }
+
+    // Iterates all entities, yielding a tuple of references to the requested components.
+    template <typename... ComponentTypes>
+    ComponentsView<ChunkType, ComponentTypes...> view()
+    {
+        return ComponentsView<ChunkType, ComponentTypes...>(m_chunks.data(), m_chunks.data() + chunks_count());
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    // Number of chunks holding entities, chunks kept for reuse are not counted.
+    std::size_t chunks_count() const
+    {
+        return (m_size + ChunkCapacity - 1) / ChunkCapacity;
+    }
+
+    ChunkType &chunk(std::size_t index)
+    {
+        return *m_chunks[index];
+    }
+
+    const ChunkType &chunk(std::size_t index) const
+    {
+        return *m_chunks[index];
+    }
+
+    // Calls function(chunk) for every chunk, chunks are split between job system workers.
+    template <typename Function>
+    void parallel_for_chunks(Function &&function, std::size_t chunks_per_job = 1)
+    {
+        const auto job = [this, &function](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                function(*m_chunks[i]);
+            }
+        };
+
+        if (m_jobs == nullptr)
+        {
+            job(0, chunks_count());
+        }
+        else
+        {
+            m_jobs->parallel_for(chunks_count(), chunks_per_job, job);
+        }
+    }
+
+    void update(SystemStage stage)
+    {
+        Tracer::Scope trace(stage == SystemStage::Simulation ? "ECS::update simulation" : "ECS::update render");
+
+        Stage &s = m_stages[static_cast<std::size_t>(stage)];
+        if (s.schedule.empty())
+        {
+            build_schedule(s);
+        }
+
+        const bool profiling = m_profiler != nullptr && m_profiler->enabled();
+        if (profiling)
+        {
+            resolve_scopes(s, m_profiler->current_scope());
+        }
+
+        run_schedule(s, profiling);
+
+        if (stage == SystemStage::Simulation)
+        {
+            ++m_ticks;
+        }
+    }
+
+private:
+    struct ScheduledSystem
+    {
+        SystemType *system = nullptr;
+        FrameProfiler::ScopeId scope = FrameProfiler::NoScope;
+        const char *trace_name = nullptr;
+    };
+
+    struct Stage
+    {
+        std::vector<std::unique_ptr<SystemType>> systems;
+        std::vector<std::vector<ScheduledSystem>> schedule;
+        FrameProfiler::ScopeId scopes_parent = FrameProfiler::NoScope;
+        bool scopes_resolved = false;
+    };
+
+    void run_schedule(const Stage &stage, bool profiling)
+    {
+        FrameProfiler *profiler = profiling ? m_profiler : nullptr;
+        const auto run = [profiler](const ScheduledSystem &s)
+        {
+            FrameProfiler::Scope scope(profiler, s.scope);
+            Tracer::Scope trace(s.trace_name);
+            s.system->update();
+        };
+
+        for (const auto &level : stage.schedule)
+        {
+            if (m_jobs == nullptr || level.size() == 1)
+            {
+                for (const auto &s : level)
+                {
+                    if (s.system->enabled())
+                    {
+                        run(s);
+                    }
+                }
+                continue;
+            }
+
+            JobCounter counter = 0;
+            for (const auto &s : level)
+            {
+                if (s.system->enabled() && !s.system->access().main_thread)
+                {
+                    m_jobs->submit([&run, &s]() { run(s); }, counter);
+                }
+            }
+
+            for (const auto &s : level)
+            {
+                if (s.system->enabled() && s.system->access().main_thread)
+                {
+                    run(s);
+                }
+            }
+
+            m_jobs->wait(counter);
+        }
+    }
+
+    // Scope ids depend on the parent scope, they are looked up again only when it changes.
+    void resolve_scopes(Stage &stage, FrameProfiler::ScopeId parent)
+    {
+        if (stage.scopes_resolved && stage.scopes_parent == parent)
+        {
+            return;
+        }
+
+        for (auto &level : stage.schedule)
+        {
+            for (auto &s : level)
+            {
+                s.scope = m_profiler->scope_id(s.system->name(), parent);
+            }
+        }
+
+        stage.scopes_parent = parent;
+        stage.scopes_resolved = true;
+    }
+
+    // Groups systems into levels. A system goes one level after the last system added before it
+    // that has conflicting access, so the systems of one level can run concurrently and the
+    // result matches running all systems in the order they were added.
+    void build_schedule(Stage &stage)
+    {
+        const auto &systems = stage.systems;
+        std::vector<std::size_t> levels(systems.size(), 0);
+
+        for (std::size_t i = 0; i < systems.size(); ++i)
+        {
+            const ComponentAccess access = systems[i]->access();
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                if (access.conflicts(systems[j]->access()))
+                {
+                    levels[i] = std::max(levels[i], levels[j] + 1);
+                }
+            }
+
+            if (stage.schedule.size() <= levels[i])
+            {
+                stage.schedule.resize(levels[i] + 1);
+            }
+            stage.schedule[levels[i]].push_back(
+                ScheduledSystem{.system = systems[i].get(), .trace_name = Tracer::instance().intern(systems[i]->name())});
+        }
+    }
+
+    struct Slot
+    {
+        std::uint32_t dense_index = Entity::InvalidIndex;
+        std::uint32_t generation = 0;
+    };
+
+    std::vector<std::unique_ptr<ChunkType>> m_chunks;
+    std::size_t m_size = 0;
+
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_dense_slots;
+    std::vector<std::uint32_t> m_free_slots;
+
+    std::array<Stage, 2> m_stages;
+    std::uint64_t m_ticks = 0;
+    std::atomic<std::uint64_t> m_version = 0;
+    JobSystem *m_jobs = nullptr;
+    FrameProfiler *m_profiler = nullptr;
+};
+
+template <typename... Types>
+using ECS = BasicECS<DefaultChunkSize, Types...>;
+
+#endif
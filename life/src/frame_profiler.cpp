@@ -0,0 +1,223 @@
+#include "frame_profiler.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+
+#if defined(__GNUG__)
+    #include <cxxabi.h>
+#endif
+
+namespace
+{
+    thread_local FrameProfiler::ScopeId current_scope_id = FrameProfiler::NoScope;
+
+    float to_ms(FrameProfiler::Clock::duration duration)
+    {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+}
+
+FrameProfiler::Scope::Scope(FrameProfiler* profiler, ScopeId id)
+    : m_profiler(id == NoScope ? nullptr : profiler), m_id(id), m_parent(current_scope_id)
+{
+    if (m_profiler != nullptr)
+    {
+        current_scope_id = m_id;
+        m_start = Clock::now();
+    }
+}
+
+FrameProfiler::Scope::~Scope()
+{
+    if (m_profiler != nullptr)
+    {
+        m_profiler->add_time(m_id, Clock::now() - m_start);
+        current_scope_id = m_parent;
+    }
+}
+
+void FrameProfiler::set_enabled(bool enabled)
+{
+    m_requested_enabled = enabled;
+}
+
+bool FrameProfiler::enabled() const
+{
+    return m_enabled;
+}
+
+FrameProfiler::Scope FrameProfiler::scope(std::string_view name)
+{
+    if (!m_enabled)
+    {
+        return Scope(nullptr, NoScope);
+    }
+
+    return Scope(this, scope_id(name, current_scope_id));
+}
+
+FrameProfiler::ScopeId FrameProfiler::scope_id(std::string_view name, ScopeId parent)
+{
+    // Registered scopes never change, so lookups do not need the lock.
+    std::size_t count = m_scopes_count.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (m_scopes[i].parent == parent && m_scopes[i].name == name)
+        {
+            return i;
+        }
+    }
+
+    std::lock_guard lock(m_registration_mutex);
+
+    const std::size_t checked = count;
+    count = m_scopes_count.load(std::memory_order_relaxed);
+    for (std::size_t i = checked; i < count; ++i)
+    {
+        if (m_scopes[i].parent == parent && m_scopes[i].name == name)
+        {
+            return i;
+        }
+    }
+
+    if (count == MaxScopesCount)
+    {
+        return NoScope;
+    }
+
+    ScopeData& scope = m_scopes[count];
+    scope.name = name;
+    scope.parent = parent;
+    scope.depth = parent == NoScope ? 0 : m_scopes[parent].depth + 1;
+    scope.history.fill(0.0f);
+
+    m_scopes_count.store(count + 1, std::memory_order_release);
+
+    return count;
+}
+
+FrameProfiler::ScopeId FrameProfiler::current_scope() const
+{
+    return current_scope_id;
+}
+
+void FrameProfiler::add_time(ScopeId id, Clock::duration duration)
+{
+    if (id != NoScope)
+    {
+        m_scopes[id].frame_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+                                        std::memory_order_relaxed);
+    }
+}
+
+void FrameProfiler::end_frame()
+{
+    const auto now = Clock::now();
+
+    if (!m_enabled)
+    {
+        m_enabled = m_requested_enabled;
+        m_last_frame_end = now;
+        return;
+    }
+    m_enabled = m_requested_enabled;
+
+    m_frames[m_history_index] = to_ms(now - m_last_frame_end);
+    m_last_frame_end = now;
+
+    const std::size_t count = m_scopes_count.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::int64_t ns = m_scopes[i].frame_ns.exchange(0, std::memory_order_relaxed);
+        m_scopes[i].history[m_history_index] = to_ms(std::chrono::nanoseconds(ns));
+    }
+
+    m_history_index = (m_history_index + 1) % HistoryFramesCount;
+    m_frames_count = std::min(m_frames_count + 1, HistoryFramesCount);
+}
+
+std::size_t FrameProfiler::scopes_count() const
+{
+    return m_scopes_count.load(std::memory_order_acquire);
+}
+
+const std::string& FrameProfiler::name(ScopeId id) const
+{
+    return m_scopes[id].name;
+}
+
+FrameProfiler::ScopeId FrameProfiler::parent(ScopeId id) const
+{
+    return m_scopes[id].parent;
+}
+
+std::size_t FrameProfiler::depth(ScopeId id) const
+{
+    return m_scopes[id].depth;
+}
+
+FrameProfiler::Stats FrameProfiler::stats(ScopeId id) const
+{
+    return compute_stats(m_scopes[id].history);
+}
+
+FrameProfiler::Stats FrameProfiler::frame_stats() const
+{
+    return compute_stats(m_frames);
+}
+
+std::array<std::size_t, FrameProfiler::HistogramBinsCount> FrameProfiler::frame_histogram() const
+{
+    std::array<std::size_t, HistogramBinsCount> bins{};
+
+    for (std::size_t i = 0; i < m_frames_count; ++i)
+    {
+        const auto bin = static_cast<std::size_t>(static_cast<double>(m_frames[i]) / HistogramBinMs);
+        ++bins[std::min(bin, HistogramBinsCount - 1)];
+    }
+
+    return bins;
+}
+
+FrameProfiler::Stats FrameProfiler::compute_stats(const History& history) const
+{
+    // Until the ring is filled the samples are at its beginning.
+    const std::size_t count = m_frames_count;
+    if (count == 0)
+    {
+        return {};
+    }
+
+    m_sorted.assign(history.begin(), history.begin() + static_cast<std::ptrdiff_t>(count));
+
+    Stats stats;
+    stats.mean_ms = std::accumulate(m_sorted.begin(), m_sorted.end(), 0.0) / static_cast<double>(count);
+
+    const auto p50 = m_sorted.begin() + static_cast<std::ptrdiff_t>(count / 2);
+    std::nth_element(m_sorted.begin(), p50, m_sorted.end());
+    stats.p50_ms = *p50;
+
+    const auto p99 = m_sorted.begin() + static_cast<std::ptrdiff_t>(std::min(count - 1, count * 99 / 100));
+    std::nth_element(p50, p99, m_sorted.end());
+    stats.p99_ms = *p99;
+
+    return stats;
+}
+
+std::string type_name(const std::type_info& type)
+{
+#if defined(__GNUG__)
+    int status = 0;
+    const std::unique_ptr<char, decltype(&std::free)> demangled(
+        abi::__cxa_demangle(type.name(), nullptr, nullptr, &status), &std::free);
+
+    if (status == 0 && demangled != nullptr)
+    {
+        return demangled.get();
+    }
+#endif
+
+    return type.name();
+}
@@ -0,0 +1,123 @@
+#ifndef LIFE_FRAME_PROFILER_HPP
+#define LIFE_FRAME_PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+
+// Collects per-frame scope timings for the in-window profiler overlay.
+//
+// Scopes form a tree: a scope opened while another one is open on the same thread becomes its
+// child. Times of a scope hit several times in a frame are summed. Every end_frame() moves the
+// frame totals into fixed rings of the last HistoryFramesCount frames, statistics are only
+// computed when asked for. While disabled scopes cost a single branch.
+class FrameProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using ScopeId = std::size_t;
+
+    static constexpr ScopeId NoScope = std::numeric_limits<ScopeId>::max();
+    static constexpr std::size_t MaxScopesCount = 64;
+    static constexpr std::size_t HistoryFramesCount = 240;
+    static constexpr std::size_t HistogramBinsCount = 12;
+    static constexpr double HistogramBinMs = 2.0;
+
+    struct Stats
+    {
+        double mean_ms = 0.0;
+        double p50_ms = 0.0;
+        double p99_ms = 0.0;
+    };
+
+    // Times the enclosing block, does nothing if the profiler was disabled when it was opened.
+    class Scope
+    {
+    public:
+        Scope(FrameProfiler* profiler, ScopeId id);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler* m_profiler;
+        ScopeId m_id;
+        ScopeId m_parent;
+        Clock::time_point m_start;
+    };
+
+    // Takes effect at the next end_frame(), so a frame never mixes scopes opened before and
+    // after the switch.
+    void set_enabled(bool enabled);
+    bool enabled() const;
+
+    // Opens a child scope of the innermost scope open on the calling thread.
+    Scope scope(std::string_view name);
+
+    // Finds or registers a scope, safe to call from any thread. The name is copied.
+    ScopeId scope_id(std::string_view name, ScopeId parent);
+
+    // Innermost scope open on the calling thread.
+    ScopeId current_scope() const;
+
+    // Adds time to the current frame of a scope, safe to call from any thread.
+    void add_time(ScopeId id, Clock::duration duration);
+
+    // Closes the current frame and applies set_enabled(). Must not overlap with open scopes.
+    void end_frame();
+
+    // Registered scopes in registration order, parents always come before their children.
+    std::size_t scopes_count() const;
+    const std::string& name(ScopeId id) const;
+    ScopeId parent(ScopeId id) const;
+    std::size_t depth(ScopeId id) const;
+    Stats stats(ScopeId id) const;
+
+    Stats frame_stats() const;
+
+    // Frame times of the history split into HistogramBinMs wide bins, the last bin also counts
+    // all longer frames.
+    std::array<std::size_t, HistogramBinsCount> frame_histogram() const;
+
+private:
+    using History = std::array<float, HistoryFramesCount>;
+
+    struct ScopeData
+    {
+        std::string name;
+        ScopeId parent = NoScope;
+        std::size_t depth = 0;
+        std::atomic<std::int64_t> frame_ns = 0;
+        History history{};
+    };
+
+    Stats compute_stats(const History& history) const;
+
+    std::array<ScopeData, MaxScopesCount> m_scopes;
+    std::atomic<std::size_t> m_scopes_count = 0;
+    std::mutex m_registration_mutex;
+
+    History m_frames{};
+    std::size_t m_frames_count = 0;
+    std::size_t m_history_index = 0;
+    Clock::time_point m_last_frame_end;
+
+    bool m_enabled = false;
+    bool m_requested_enabled = false;
+
+    mutable std::vector<float> m_sorted;
+};
+
+// Readable name of a type, demangled where the ABI allows it.
+std::string type_name(const std::type_info& type);
+
+#endif
@@ -0,0 +1,209 @@
+#include "gpu_simulation.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include <graphics/color.hpp>
+#include <math/math.hpp>
+
+namespace N = neutrino;
+namespace NG = neutrino::graphics;
+namespace NM = neutrino::math;
+
+namespace
+{
+    constexpr std::size_t QuadVerticesCount = 4;
+    constexpr std::uint32_t QuadIndices[] = {0, 1, 2, 0, 2, 3};
+
+    const std::string BoundsUniform = "bounds";
+    const std::string TicksUniform = "ticks";
+
+    // Division rounding towards negative infinity, divisor is positive.
+    std::int64_t floor_div(std::int64_t value, std::int64_t divisor)
+    {
+        const std::int64_t quotient = value / divisor;
+        return quotient * divisor > value ? quotient - 1 : quotient;
+    }
+}
+
+GpuSimulation::GpuSimulation(NG::Renderer& renderer, ResourceId mesh_id, ResourceId shader_id, N::Size bounds)
+    : m_renderer(renderer), m_mesh_id(mesh_id), m_shader_id(shader_id), m_bounds(bounds)
+{
+}
+
+void GpuSimulation::upload(const ECSType& storage)
+{
+    // Attributes: vertex - start position and quad corner index, normal - offset per tick,
+    // tangent - size, color - color. Every entity has its own four vertices.
+    NG::Mesh::VertexData vertices;
+    NG::Mesh::NormalsData offsets;
+    NG::Mesh::TangentsData sizes;
+    NG::Mesh::ColorData colors;
+    NG::Mesh::IndicesData indices;
+
+    const std::size_t count = storage.size();
+    vertices.reserve(count * QuadVerticesCount);
+    offsets.reserve(count * QuadVerticesCount);
+    sizes.reserve(count * QuadVerticesCount);
+    colors.reserve(count * QuadVerticesCount);
+    indices.reserve(count * std::size(QuadIndices));
+
+    for (std::size_t c = 0; c < storage.chunks_count(); ++c)
+    {
+        const auto& chunk = storage.chunk(c);
+        const auto positions = chunk.components<PositionComponent>();
+        const auto movements = chunk.components<MovementComponent>();
+        const auto entity_sizes = chunk.components<SizeComponent>();
+        const auto renders = chunk.components<RenderComponent>();
+
+        for (std::size_t i = 0; i < chunk.size(); ++i)
+        {
+            const auto first_vertex = static_cast<std::uint32_t>(vertices.size());
+            for (const auto index : QuadIndices)
+            {
+                indices.push_back(first_vertex + index);
+            }
+
+            for (std::size_t corner = 0; corner < QuadVerticesCount; ++corner)
+            {
+                vertices.push_back(NM::Vector3f{positions[i].pos, static_cast<float>(corner)});
+                offsets.push_back(NM::Vector3f{movements[i].offset, 0});
+                sizes.push_back(NM::Vector3f{entity_sizes[i].size, 0});
+                colors.push_back(NG::Color(renders[i].color));
+            }
+        }
+    }
+
+    m_mesh = NG::Mesh();
+    m_mesh.set_vertices(std::move(vertices));
+    m_mesh.set_normals(std::move(offsets));
+    m_mesh.set_tangents(std::move(sizes));
+    m_mesh.set_colors(std::move(colors));
+    m_mesh.add_submesh(std::move(indices));
+
+    m_renderer.load(m_mesh_id, m_mesh);
+
+    m_uploaded_count = count;
+    m_upload_tick = storage.ticks();
+    m_uploaded = true;
+}
+
+void GpuSimulation::download(ECSType& storage) const
+{
+    const std::int64_t ticks = elapsed_ticks(storage);
+    if (!m_uploaded || ticks == 0)
+    {
+        return;
+    }
+
+    for (std::size_t c = 0; c < storage.chunks_count(); ++c)
+    {
+        auto& chunk = storage.chunk(c);
+        const auto positions = chunk.components<PositionComponent>();
+        const auto movements = chunk.components<MovementComponent>();
+        const auto sizes = chunk.components<SizeComponent>();
+        const auto previous_positions = chunk.components<PreviousPositionComponent>();
+
+        for (std::size_t i = 0; i < chunk.size(); ++i)
+        {
+            auto& pos = positions[i].pos;
+            auto& offset = movements[i].offset;
+            const auto& size = sizes[i].size;
+
+            reflect_motion(pos.x, offset.x, size.x, m_bounds.width, ticks);
+            reflect_motion(pos.y, offset.y, size.y, m_bounds.height, ticks);
+
+            previous_positions[i].pos = pos;
+        }
+
+        storage.mark_changed<PositionComponent, PreviousPositionComponent, MovementComponent>(chunk);
+    }
+}
+
+void GpuSimulation::sync(ECSType& storage)
+{
+    if (m_uploaded_count == storage.size())
+    {
+        download(storage);
+    }
+
+    upload(storage);
+}
+
+void GpuSimulation::render(const ECSType& storage, float alpha)
+{
+    const float ticks = static_cast<float>(elapsed_ticks(storage)) + alpha;
+
+    m_renderer.render(m_mesh_id,
+                      m_shader_id,
+                      {NG::Uniform{BoundsUniform, NM::Vector2f{m_bounds.width, m_bounds.height}},
+                       NG::Uniform{TicksUniform, ticks}});
+}
+
+bool GpuSimulation::needs_upload(const ECSType& storage) const
+{
+    return !m_uploaded || m_uploaded_count != storage.size() || elapsed_ticks(storage) >= MaxTicks;
+}
+
+bool GpuSimulation::uploaded() const
+{
+    return m_uploaded;
+}
+
+void GpuSimulation::reset()
+{
+    m_uploaded = false;
+}
+
+std::int64_t GpuSimulation::elapsed_ticks(const ECSType& storage) const
+{
+    return static_cast<std::int64_t>(storage.ticks() - m_upload_tick);
+}
+
+void reflect_motion(int& position, int& offset, int size, int bound, std::int64_t ticks)
+{
+    // Same math as in gpu_particle.vert. The kernel turns an entity around on the tick after
+    // it has crossed a wall, so on the lattice of positions it can reach the entity moves
+    // like a triangle wave between the first reachable points past each wall. An entity
+    // that is past a wall and would still be past one after turning around never gets
+    // back, it swaps between these two points.
+    const std::int64_t speed = std::abs(offset);
+    if (speed == 0 || ticks == 0)
+    {
+        return;
+    }
+
+    const std::int64_t low = size / 2;
+    const std::int64_t high = bound - size / 2;
+    const auto outside = [low, high](std::int64_t x) { return x < low || x > high; };
+
+    const std::int64_t start = position;
+    const bool turning = outside(start);
+    const std::int64_t next = turning ? start - offset : start + offset;
+
+    std::int64_t first = 0;
+    std::int64_t last = 0;
+    if (turning && outside(next))
+    {
+        first = std::min(start, next);
+        last = std::max(start, next);
+    }
+    else
+    {
+        first = start - speed * (floor_div(start - low, speed) + 1);
+        last = start + speed * (floor_div(high - start, speed) + 1);
+    }
+
+    const std::int64_t range = last - first;
+    const std::int64_t period = 2 * range;
+
+    // Phase in [0, range] moves towards last, in [range, period) towards first.
+    const bool forward = (turning ? -offset : offset) > 0;
+    const std::int64_t phase = forward ? start - first : period - (start - first);
+    const std::int64_t t = (phase + speed * (ticks % period)) % period;
+
+    // Offset keeps its sign at the turning points, the kernel flips it on the next tick.
+    position = static_cast<int>(first + std::min(t, period - t));
+    offset = static_cast<int>(t > 0 && t <= range ? speed : -speed);
+}
@@ -0,0 +1,71 @@
+#ifndef LIFE_GPU_SIMULATION_HPP
+#define LIFE_GPU_SIMULATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <common/size.hpp>
+#include <graphics/mesh.hpp>
+#include <graphics/renderer.hpp>
+
+#include "components.hpp"
+
+// Movement evaluated on the GPU.
+//
+// Entity state is uploaded once as a static mesh and the particle shader computes the
+// position for the current tick in closed form, so nothing is uploaded per frame. The
+// storage is only read on upload and written back on download, when the CPU needs the
+// current state: on mode switches, when the entity set changes and on tick rebase.
+class GpuSimulation
+{
+public:
+    using ResourceId = neutrino::graphics::Renderer::ResourceId;
+
+    // Ticks are passed to the shader as float, rebasing keeps all shader math exact integers.
+    static constexpr std::int64_t MaxTicks = 1 << 16;
+
+    GpuSimulation(neutrino::graphics::Renderer& renderer,
+                  ResourceId mesh_id,
+                  ResourceId shader_id,
+                  neutrino::Size bounds);
+
+    // Uploads current storage state, the shader counts ticks from the current storage tick.
+    void upload(const ECSType& storage);
+
+    // Writes the state of the current tick back into the storage.
+    void download(ECSType& storage) const;
+
+    // Brings the uploaded state up to date: writes it back if the entity set did not change,
+    // then uploads again.
+    void sync(ECSType& storage);
+
+    // Draws the state between the current storage tick and the next one, alpha is in [0, 1].
+    void render(const ECSType& storage, float alpha);
+
+    // Upload is required when entities were added or removed, or ticks are close to overflow.
+    bool needs_upload(const ECSType& storage) const;
+
+    bool uploaded() const;
+
+    // Drops uploaded state without writing it back.
+    void reset();
+
+private:
+    neutrino::graphics::Renderer& m_renderer;
+    ResourceId m_mesh_id;
+    ResourceId m_shader_id;
+    neutrino::Size m_bounds;
+
+    neutrino::graphics::Mesh m_mesh;
+    std::int64_t elapsed_ticks(const ECSType& storage) const;
+
+    std::size_t m_uploaded_count = 0;
+    std::uint64_t m_upload_tick = 0;
+    bool m_uploaded = false;
+};
+
+// CPU version of the shader motion: position and offset along one axis after ticks steps
+// of reflecting from the walls of [0, bound] for an entity of the given size.
+void reflect_motion(int& position, int& offset, int size, int bound, std::int64_t ticks);
+
+#endif
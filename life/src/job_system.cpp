@@ -0,0 +1,202 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "tracer.hpp"
+
+namespace
+{
+    // Queue 0 is shared by all threads that do not belong to the pool.
+    thread_local std::size_t current_queue_index = 0;
+}
+
+JobSystem::JobSystem(std::size_t workers_count)
+{
+    m_queues.reserve(workers_count + 1);
+    for (std::size_t i = 0; i < workers_count + 1; ++i)
+    {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    m_workers.reserve(workers_count);
+    for (std::size_t i = 0; i < workers_count; ++i)
+    {
+        m_workers.emplace_back([this, i]() { worker_loop(i + 1); });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(Job job, JobCounter& counter)
+{
+    counter.fetch_add(1, std::memory_order_relaxed);
+
+    // The task is counted before it becomes visible, a thread that steals it right away
+    // must not take the count below zero.
+    Queue& queue = *m_queues[current_queue_index];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        m_queued_count.fetch_add(1, std::memory_order_relaxed);
+        queue.push_back(Task{.job = std::move(job), .counter = &counter});
+    }
+
+    // Taking the wake mutex orders the increment with a worker that is about to check
+    // the count and go to sleep, so the notification is not lost.
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+    }
+    m_wake.notify_one();
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    while (counter.load(std::memory_order_acquire) > 0)
+    {
+        if (!try_run_one())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallel_for(std::size_t count, std::size_t grain, const RangeJob& job)
+{
+    grain = std::max<std::size_t>(grain, 1);
+
+    if (m_workers.empty() || count <= grain)
+    {
+        job(0, count);
+        return;
+    }
+
+    // Pieces capture only a reference to the range and their begin, small enough for
+    // std::function to store them without a heap allocation.
+    struct Range
+    {
+        const RangeJob& job;
+        std::size_t grain;
+        std::size_t count;
+    };
+    const Range range{job, grain, count};
+
+    JobCounter counter = 0;
+    for (std::size_t begin = grain; begin < count; begin += grain)
+    {
+        submit([&range, begin]() { range.job(begin, std::min(begin + range.grain, range.count)); }, counter);
+    }
+
+    // The first piece is done by the calling thread right away.
+    job(0, grain);
+
+    wait(counter);
+}
+
+std::size_t JobSystem::workers_count() const
+{
+    return m_workers.size();
+}
+
+std::size_t JobSystem::default_workers_count()
+{
+    const std::size_t hardware_threads = std::thread::hardware_concurrency();
+    return hardware_threads > 1 ? hardware_threads - 1 : 0;
+}
+
+bool JobSystem::try_run_one()
+{
+    Task task;
+
+    // Own queue is used as LIFO, other queues are robbed from the front.
+    {
+        Queue& own = *m_queues[current_queue_index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.size != 0)
+        {
+            task = own.pop_back();
+        }
+    }
+
+    for (std::size_t i = 1; !task.job && i < m_queues.size(); ++i)
+    {
+        Queue& victim = *m_queues[(current_queue_index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.size != 0)
+        {
+            task = victim.pop_front();
+        }
+    }
+
+    if (!task.job)
+    {
+        return false;
+    }
+
+    m_queued_count.fetch_sub(1, std::memory_order_relaxed);
+    task.job();
+    task.counter->fetch_sub(1, std::memory_order_release);
+
+    return true;
+}
+
+void JobSystem::worker_loop(std::size_t queue_index)
+{
+    current_queue_index = queue_index;
+    Tracer::instance().set_thread_name("job worker " + std::to_string(queue_index));
+
+    while (m_running)
+    {
+        if (try_run_one())
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wake_mutex);
+        m_wake.wait(lock, [this]() { return !m_running || m_queued_count.load(std::memory_order_relaxed) > 0; });
+    }
+}
+
+void JobSystem::Queue::push_back(Task task)
+{
+    if (size == tasks.size())
+    {
+        std::vector<Task> grown(std::max<std::size_t>(tasks.size() * 2, 16));
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            grown[i] = std::move(tasks[(head + i) % tasks.size()]);
+        }
+
+        tasks = std::move(grown);
+        head = 0;
+    }
+
+    tasks[(head + size) % tasks.size()] = std::move(task);
+    ++size;
+}
+
+JobSystem::Task JobSystem::Queue::pop_back()
+{
+    --size;
+    return std::exchange(tasks[(head + size) % tasks.size()], Task{});
+}
+
+JobSystem::Task JobSystem::Queue::pop_front()
+{
+    Task task = std::exchange(tasks[head], Task{});
+    head = (head + 1) % tasks.size();
+    --size;
+    return task;
+}
@@ -0,0 +1,78 @@
+#ifndef LIFE_JOB_SYSTEM_HPP
+#define LIFE_JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using JobCounter = std::atomic<std::size_t>;
+
+// Work-stealing thread pool.
+//
+// Every worker has its own queue and takes its newest job first, idle workers steal the
+// oldest jobs from the other queues. A thread that waits for a counter keeps executing
+// queued jobs meanwhile, so jobs may safely submit and wait for nested jobs.
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(std::size_t begin, std::size_t end)>;
+
+    // Main thread helps while it waits, so the pool leaves one hardware thread to it.
+    explicit JobSystem(std::size_t workers_count = default_workers_count());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queues the job, counter is decremented when the job is finished.
+    void submit(Job job, JobCounter& counter);
+
+    // Returns when counter reaches zero.
+    void wait(const JobCounter& counter);
+
+    // Splits range [0, count) into pieces of at most grain items and runs them in parallel.
+    void parallel_for(std::size_t count, std::size_t grain, const RangeJob& job);
+
+    std::size_t workers_count() const;
+
+    static std::size_t default_workers_count();
+
+private:
+    struct Task
+    {
+        Job job;
+        JobCounter* counter = nullptr;
+    };
+
+    // Ring buffer of tasks that only grows, so queuing jobs in steady state does not allocate.
+    struct Queue
+    {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        std::size_t head = 0;
+        std::size_t size = 0;
+
+        void push_back(Task task);
+        Task pop_back();
+        Task pop_front();
+    };
+
+    bool try_run_one();
+    void worker_loop(std::size_t queue_index);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::atomic<std::size_t> m_queued_count = 0;
+    std::atomic<bool> m_running = true;
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+};
+
+#endif
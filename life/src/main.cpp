@@ -1,24 +1,49 @@
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
-#include <array>
-#include <variant>
 #include <filesystem>
+#include <future>
+#include <utility>
 
 #include <common/utils.hpp>
 #include <graphics/color.hpp>
 #include <graphics/font.hpp>
 #include <graphics/mesh.hpp>
 #include <graphics/renderer.hpp>
-#include <graphics/shader.hpp>
 #include <log/log.hpp>
 #include <log/stream_logger.hpp>
 #include <math/math.hpp>
 #include <system/window.hpp>
 #include <profiler/profiler.hpp>
 
+#include "asset_loader.hpp"
+#include "collision_system.hpp"
+#include "components.hpp"
+#include "counter_random.hpp"
+#include "ecs.hpp"
+#include "frame_profiler.hpp"
+#include "frame_stats.hpp"
+#include "gpu_simulation.hpp"
+#include "job_system.hpp"
+#include "movement_kernel.hpp"
+#include "movement_system.hpp"
+#include "quad_batch.hpp"
+#include "shader_loader.hpp"
+#include "snapshot.hpp"
+#include "stream_buffer.hpp"
+#include "text_cache.hpp"
+#include "tracer.hpp"
+#include "view_culling.hpp"
+
 namespace N = neutrino;
 namespace NS = neutrino::system;
 namespace NG = neutrino::graphics;
@@ -32,334 +57,478 @@ namespace
     const std::filesystem::path fragment_shader = "data/fragment.frag";
     const std::filesystem::path particle_vertex_shader = "data/particle.vert";
     const std::filesystem::path text_vertex_shader = "data/text.vert";
+    const std::filesystem::path batch_vertex_shader = "data/batch.vert";
+    const std::filesystem::path gpu_particle_vertex_shader = "data/gpu_particle.vert";
+
+    // Uniform names are built once instead of on every draw call.
+    const std::string PositionUniform = "pos";
+    const std::string SizeUniform = "size";
+    const std::string ColorUniform = "color";
 
     const NG::Mesh::VertexData vertices = {{-0.5, -0.5, 0.0}, {0.5, -0.5, 0.0}, {0.5, 0.5, 0.0}, {-0.5, 0.5, 0.0}};
     NG::Mesh::IndicesData indices = {0, 1, 2, 0, 2, 3};
 
-    constexpr std::size_t EntityesCount = 100000;
+    constexpr std::size_t DefaultEntitiesCount = 100000;
+    constexpr std::size_t SpawnStep = 10000;
     constexpr std::size_t MaxUniformsCount = 100;
-}
 
-struct RenderComponent
-{
-    NG::Colorf color;
-};
+    const N::Size WorldSize = {800, 600};
 
-struct SizeComponent
-{
-    NM::Vector2i size;
-};
+    const std::filesystem::path SnapshotPath = "life.snapshot";
+    const std::filesystem::path TracePath = "Life.trace.json";
 
-struct PositionComponent
-{
-    NM::Vector2i pos;
-};
+    constexpr std::size_t MaxHudLinesCount = 24;
+    constexpr auto HudRefreshInterval = std::chrono::milliseconds(250);
 
-struct MovementComponent
-{
-    NM::Vector2i offset;
-};
+    constexpr double DefaultSimulationRate = 60.0;
+    constexpr double MaxSimulationRate = 1000.0;
+    constexpr std::size_t MaxSimulationStepsPerFrame = 5;
 
-template <typename VariantType, typename T, std::size_t index = 0>
-inline constexpr std::size_t get_component_index()
-{
-    static_assert(std::variant_size_v<VariantType> > index, "Type not found in variant");
+    constexpr auto AssetUploadBudget = std::chrono::milliseconds(2);
 
-    if constexpr (index == std::variant_size_v<VariantType>)
-    {
-        return index;
-    }
-    else if constexpr (std::is_same_v<std::variant_alternative_t<index, VariantType>, T>)
+    using ShaderSources = std::vector<std::pair<std::filesystem::path, std::string>>;
+
+    // True if the whole text is a number and it was stored into value.
+    template <typename T>
+    bool parse_number(const char *text, T &value)
     {
-        return index;
+        const std::string_view view(text);
+        const auto [end, error] = std::from_chars(view.data(), view.data() + view.size(), value);
+        return error == std::errc() && end == view.data() + view.size();
     }
-    else
+
+    // True once the load has finished, rethrows the error it failed with.
+    bool finished(std::future<void> &load)
     {
-        return get_component_index<VariantType, T, index + 1>();
+        if (!load.valid())
+        {
+            return true;
+        }
+        if (load.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return false;
+        }
+
+        load.get();
+        return true;
     }
 }
 
-template <typename VariantType, typename ComponentType>
-static inline constexpr std::size_t component_index_v = get_component_index<VariantType, ComponentType>();
-
-template <typename... Types>
-inline constexpr auto wrap_in_variant(const Types &...)
+enum class RenderMode
 {
-    return std::variant<Types...>();
-}
+    UniformArrays,
+    BatchedMesh,
+    GpuSimulation,
+};
 
-template <typename... Types>
-inline constexpr auto wrap_in_variant_of_vectors(const Types &...)
+struct RenderResources
 {
-    return wrap_in_variant(std::vector<Types>()...);
-}
-
-template <typename... Types>
-using wrap_in_variant_of_vectors_t = decltype(wrap_in_variant_of_vectors(Types()...));
+    NG::Renderer::ResourceId mesh_id;
+    NG::Renderer::ResourceId shader_id;
+    NG::Renderer::ResourceId batch_mesh_id;
+    NG::Renderer::ResourceId batch_shader_id;
+    NG::Renderer::ResourceId gpu_mesh_id;
+    NG::Renderer::ResourceId gpu_shader_id;
+};
 
-template <typename ECSType>
-class System
+class RenderSystem final : public ECSType::SystemType
 {
 public:
-    virtual ~System() = default;
-
-    void set_storage(ECSType *storage)
+    RenderSystem(NG::Renderer &renderer, const RenderResources &resources, N::Size world_size)
+        : m_renderer(renderer), m_mesh_id(resources.mesh_id), m_shader_id(resources.shader_id),
+          m_batch_shader_id(resources.batch_shader_id), m_stream(renderer, resources.batch_mesh_id),
+          m_gpu(renderer, resources.gpu_mesh_id, resources.gpu_shader_id, world_size)
     {
-        m_storage = storage;
+        m_positions.reserve(MaxUniformsCount);
+        m_sizes.reserve(MaxUniformsCount);
+        m_colors.reserve(MaxUniformsCount);
     }
 
-    const ECSType &storage() const
+    void set_mode(RenderMode mode)
     {
-        return *m_storage;
+        // Storage keeps the state of the last upload, bring it up to date for the CPU simulation.
+        if (m_mode == RenderMode::GpuSimulation && mode != RenderMode::GpuSimulation)
+        {
+            m_gpu.download(storage());
+            m_gpu.reset();
+        }
+
+        m_mode = mode;
     }
 
-    ECSType &storage()
+    // Must be called before entities are created or destroyed, so the storage
+    // holds the current state in every mode.
+    void sync_storage()
     {
-        return *m_storage;
+        if (m_mode == RenderMode::GpuSimulation)
+        {
+            m_gpu.download(storage());
+            m_gpu.reset();
+        }
     }
 
-    virtual void update() = 0;
-
-private:
-    ECSType *m_storage;
-};
-
-template <typename... Types>
-class ECS
-{
-public:
-    template <typename T>
-    using StorageContainer = std::vector<T>;
-    using StorageItemType = wrap_in_variant_of_vectors_t<Types...>;
-    using StorageType = std::array<StorageItemType, std::variant_size_v<StorageItemType>>;
-    using SystemType = System<ECS<Types...>>;
-
-    ECS()
+    RenderMode mode() const
     {
-        std::size_t i = 0;
-        (void(m_storage[i++] = StorageContainer<Types>()), ...);
+        return m_mode;
     }
 
-    template <typename ComponentType>
-    void add_component(ComponentType component)
+    // Entities outside of the view are not drawn by the CPU-fed render modes.
+    void set_view(N::Size size)
     {
-        using ContainerType = StorageContainer<ComponentType>;
-        static constexpr std::size_t index = component_index_v<StorageItemType, ContainerType>;
-        std::get<ContainerType>(m_storage[index]).push_back(component);
+        m_culling.set_view(size);
     }
 
-    void add_system(std::unique_ptr<SystemType> system)
+    void set_lod_enabled(bool enabled)
     {
-        system->set_storage(this);
-        m_systems.push_back(std::move(system));
+        m_culling.set_lod_enabled(enabled);
     }
 
-    template <typename ComponentType>
-    const ComponentType &component(std::size_t index) const
+    bool lod_enabled() const
     {
-        return components_container<ComponentType>()[index];
+        return m_culling.lod_enabled();
     }
 
-    template <typename ComponentType>
-    ComponentType &component(std::size_t index)
+    // Entities drawn in the last frame, all of them in the GPU simulation mode.
+    std::size_t visible_count() const
     {
-        return components_container<ComponentType>()[index];
+        return m_visible_count;
     }
 
-    template <typename ComponentType>
-    StorageContainer<ComponentType> &components_container()
+    // Fraction of the simulation step passed since the last simulation update.
+    void set_interpolation(float alpha)
     {
-        using ContainerType = StorageContainer<ComponentType>;
-        static constexpr std::size_t container_index = component_index_v<StorageItemType, ContainerType>;
-        return std::get<ContainerType>(m_storage[container_index]);
+        m_alpha = alpha;
     }
 
-    template <typename ComponentType>
-    const StorageContainer<ComponentType> &components_container() const
+    // Writes positions and offsets back when the GPU simulation is synchronized.
+    ComponentAccess access() const override
     {
-        using ContainerType = StorageContainer<ComponentType>;
-        static constexpr std::size_t container_index = component_index_v<StorageItemType, ContainerType>;
-        return std::get<ContainerType>(m_storage[container_index]);
+        return {.reads = ECSType::components_mask<SizeComponent, RenderComponent>(),
+                .writes =
+                    ECSType::components_mask<PositionComponent, PreviousPositionComponent, MovementComponent>(),
+                .main_thread = true};
     }
 
-    void update()
+    void update() override
     {
-        for (auto &s : m_systems)
+        switch (m_mode)
         {
-            s->update();
+        case RenderMode::UniformArrays:
+            render_uniform_arrays();
+            break;
+        case RenderMode::BatchedMesh:
+            render_batched_mesh();
+            break;
+        case RenderMode::GpuSimulation:
+            render_gpu_simulation();
+            break;
         }
     }
 
 private:
-    StorageType m_storage;
-    std::vector<std::unique_ptr<SystemType>> m_systems;
-};
-
-using ECSType = ECS<RenderComponent, SizeComponent, PositionComponent, MovementComponent>;
-
-class RenderSystem final : public ECSType::SystemType
-{
-public:
-    RenderSystem(NG::Renderer &renderer, NG::Renderer::ResourceId mesh_id,
-                 NG::Renderer::ResourceId shader_id)
-        : m_renderer(renderer), m_mesh_id(mesh_id), m_shader_id(shader_id) {}
-
-    void update() override
+    void render_uniform_arrays()
     {
-        for (std::size_t index = 0; index < EntityesCount; index += MaxUniformsCount)
+        m_culling.begin_frame();
+        m_visible_count = 0;
+
+        const std::size_t entities_count = storage().size();
+        for (std::size_t index = 0; index < entities_count; ++index)
         {
-            std::vector<NM::Vector3f> positions;
-            std::vector<NM::Vector3f> sizes;
-            std::vector<NG::Colorf> colors;
+            const auto &p = storage().component<PositionComponent>(index);
+            const auto &pp = storage().component<PreviousPositionComponent>(index);
+            const auto &s = storage().component<SizeComponent>(index);
 
-            for (std::size_t i = 0; i < MaxUniformsCount; ++i)
-            {
-                const auto &p = storage().component<PositionComponent>(index + i);
-                const auto &s = storage().component<SizeComponent>(index + i);
-                const auto &r = storage().component<RenderComponent>(index + i);
+            const NM::Vector2f pos = interpolate(pp.pos, p.pos, m_alpha);
+            const float half_width = static_cast<float>(s.size.x) * 0.5f;
+            const float half_height = static_cast<float>(s.size.y) * 0.5f;
 
-                positions.push_back(NM::Vector3f{p.pos, 0});
-                sizes.push_back(NM::Vector3f{s.size, 1});
-                colors.push_back(r.color);
+            if (!m_culling.visible(pos.x - half_width, pos.y - half_height, pos.x + half_width, pos.y + half_height))
+            {
+                continue;
             }
 
-            m_renderer.render(m_mesh_id,
-                              m_shader_id,
-                              MaxUniformsCount,
-                              {NG::Uniform{"pos", positions},
-                               NG::Uniform{"size", sizes},
-                               NG::Uniform{"color", colors}});
+            m_positions.push_back(NM::Vector3f{pos, 0});
+            m_sizes.push_back(NM::Vector3f{s.size, 1});
+            m_colors.push_back(storage().component<RenderComponent>(index).color);
+
+            if (m_positions.size() == MaxUniformsCount)
+            {
+                flush_uniform_arrays();
+            }
         }
-    }
 
-private:
-    NG::Renderer &m_renderer;
-    NG::Renderer::ResourceId m_mesh_id;
-    NG::Renderer::ResourceId m_shader_id;
-};
+        flush_uniform_arrays();
+    }
 
-class MovementSystem : public ECSType::SystemType
-{
-public:
-    MovementSystem(N::Size size)
-        : m_size(size)
+    // Draws the entities collected so far with one instanced call.
+    void flush_uniform_arrays()
     {
+        if (m_positions.empty())
+        {
+            return;
+        }
+
+        m_renderer.render(m_mesh_id,
+                          m_shader_id,
+                          m_positions.size(),
+                          {NG::Uniform{PositionUniform, m_positions},
+                           NG::Uniform{SizeUniform, m_sizes},
+                           NG::Uniform{ColorUniform, m_colors}});
+
+        m_visible_count += m_positions.size();
+
+        m_positions.clear();
+        m_sizes.clear();
+        m_colors.clear();
     }
 
-    void update() override
+    // All entities are expanded into one mesh with per-vertex position and color,
+    // so the whole population is uploaded as a single buffer and drawn with one call.
+    void render_batched_mesh()
     {
-        for (std::size_t index = 0; index < EntityesCount; ++index)
-        {
-            auto &p = storage().component<PositionComponent>(index);
-            auto &s = storage().component<SizeComponent>(index);
-            auto &m = storage().component<MovementComponent>(index);
+        m_stream.begin_frame(storage().size());
 
-            const auto &pos = p.pos;
-            const auto &size = s.size;
+        const auto vertices = m_stream.vertices();
+        const auto colors = m_stream.colors();
 
-            if (pos.x + size.x / 2 > m_size.width || pos.x - size.x / 2 < 0)
-            {
-                m.offset.x *= -1;
-            }
+        // Colors only change with the render components. While all entities are drawn in storage
+        // order, the colors the slot got the last time it was used are still in place.
+        const std::uint64_t colors_version = storage().column_version<RenderComponent>();
+        const bool reuse_colors = colors_version != 0 && m_stream.colors_version() == colors_version;
 
-            if (pos.y + size.y / 2 > m_size.height || pos.y - size.y / 2 < 0)
-            {
-                m.offset.y *= -1;
-            }
+        m_culling.begin_frame();
+        m_visible_count =
+            write_quads(storage(), m_alpha, vertices, reuse_colors ? std::span<NG::Color>{} : colors, &m_culling);
 
-            p.pos += m.offset;
+        const bool all_drawn = m_visible_count == storage().size();
+        if (reuse_colors && !all_drawn)
+        {
+            // Some entities were culled or merged, quads moved and need their colors written.
+            m_culling.begin_frame();
+            m_visible_count = write_quads(storage(), m_alpha, vertices, colors, &m_culling);
         }
+        m_stream.set_colors_version(all_drawn ? colors_version : 0);
+
+        m_stream.submit(m_batch_shader_id, m_visible_count);
     }
 
-private:
-    N::Size m_size;
+    // Movement is computed by the particle shader, the storage is only touched on synchronization.
+    void render_gpu_simulation()
+    {
+        if (m_gpu.needs_upload(storage()))
+        {
+            m_gpu.sync(storage());
+        }
+
+        m_gpu.render(storage(), m_alpha);
+        m_visible_count = storage().size();
+    }
+
+    NG::Renderer &m_renderer;
+    NG::Renderer::ResourceId m_mesh_id;
+    NG::Renderer::ResourceId m_shader_id;
+    NG::Renderer::ResourceId m_batch_shader_id;
+
+    RenderMode m_mode = RenderMode::BatchedMesh;
+    float m_alpha = 1.0f;
+
+    std::vector<NM::Vector3f> m_positions;
+    std::vector<NM::Vector3f> m_sizes;
+    std::vector<NG::Colorf> m_colors;
+
+    StreamBuffer m_stream;
+    GpuSimulation m_gpu;
+
+    ViewCulling m_culling;
+    std::size_t m_visible_count = 0;
 };
 
 class App
 {
 public:
-    App()
-        : m_window("Life", {800, 600}), m_renderer(m_window.context())
+    App(std::size_t entities_count, double simulation_rate)
+        : m_window("Life", {800, 600}),
+          m_renderer(m_window.context()),
+          m_shaders(m_renderer),
+          m_initial_entities_count(entities_count),
+          m_text_cache(m_renderer, m_font, m_text_id),
+          m_hud_text_cache(m_renderer, m_font, m_hud_text_id, MaxHudLinesCount),
+          m_simulation_step(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(1.0 / simulation_rate)))
     {
     }
 
     void init()
     {
+        m_ecs.set_job_system(&m_jobs);
+        m_ecs.set_profiler(&m_profiler);
+        NL::info("Life") << "Movement kernel: " << movement_kernel_name() << ", workers: " << m_jobs.workers_count();
+
         m_window.set_on_resize_callback([this](N::Size size)
                                         { on_resize(size); });
+        m_window.set_on_key_up_callback([this](NS::KeyCode key, NS::Modifiers)
+                                        { on_key_up(key); });
 
-        for (std::size_t i = 0; i < EntityesCount; ++i)
-        {
-            const auto color = NU::random_numbers<float>(0.2f, 1.0f, 3);
-            const auto size = NU::random_numbers<int>(10, 20, 2);
-            const auto pos = NU::random_numbers<int>(100, 200, 2);
-            const auto offset = NU::random_numbers<int>(-10, 10, 2);
+        spawn_entities(m_initial_entities_count);
 
-            RenderComponent r{.color{color[0], color[1], color[1], 1.0f}};
-            SizeComponent s{.size{size[0], size[1]}};
-            PositionComponent p{.pos{pos[0], pos[1]}};
-            MovementComponent m{.offset{offset[0], offset[1]}};
+        auto movement_system = std::make_unique<MovementSystem>(WorldSize);
+        m_movement_system = movement_system.get();
+        m_ecs.add_system(std::move(movement_system));
 
-            m_ecs.add_component(r);
-            m_ecs.add_component(s);
-            m_ecs.add_component(p);
-            m_ecs.add_component(m);
-        }
+        // Entity-entity collisions are off by default, C toggles them.
+        auto collision_system = std::make_unique<CollisionSystem>(WorldSize);
+        m_collision_system = collision_system.get();
+        m_collision_system->set_enabled(false);
+        m_ecs.add_system(std::move(collision_system));
+
+        m_renderer.set_clear_color(NG::Color(0x2F2F2FFFU));
 
-        m_ecs.add_system(std::make_unique<RenderSystem>(m_renderer, m_mesh_id, m_particle_shader_id));
-        m_ecs.add_system(std::make_unique<MovementSystem>(N::Size(800, 600)));
+        load_assets();
+    }
 
-        if (m_font.load("data/UbuntuMono-Regular.ttf") != NG::Font::LoadResult::Success)
-        {
-            throw std::runtime_error("Can't load font.");
-        }
+    // Assets load in the background, so the window shows right away. The scene and the text
+    // appear once their assets are uploaded, see update_assets().
+    void load_assets()
+    {
+        m_font_load = m_assets.load(
+            [this]
+            {
+                if (m_font.load("data/UbuntuMono-Regular.ttf") != NG::Font::LoadResult::Success)
+                {
+                    throw std::runtime_error("Can't load font.");
+                }
+            },
+            [] {});
+
+        m_shaders_load = m_assets.load(
+            []
+            {
+                ShaderSources sources;
+                for (const auto &path : {fragment_shader,
+                                         particle_vertex_shader,
+                                         batch_vertex_shader,
+                                         gpu_particle_vertex_shader,
+                                         text_vertex_shader})
+                {
+                    sources.emplace_back(path, ShaderLoader::read_source(path));
+                }
+                return sources;
+            },
+            [this](ShaderSources sources)
+            {
+                for (auto &[path, text] : sources)
+                {
+                    m_shaders.add_source(path, std::move(text));
+                }
+
+                m_shaders.load(m_particle_shader_id, particle_vertex_shader, fragment_shader);
+                m_shaders.load(m_batch_shader_id, batch_vertex_shader, fragment_shader);
+                m_shaders.load(m_gpu_shader_id, gpu_particle_vertex_shader, fragment_shader);
+                m_shaders.load(m_text_shader_id, text_vertex_shader, fragment_shader);
+            });
+
+        m_mesh_load = m_assets.load(
+            []
+            {
+                NG::Mesh mesh;
+                mesh.set_vertices(vertices);
+                mesh.add_submesh(indices);
+                return mesh;
+            },
+            [this](NG::Mesh mesh) { m_renderer.load(m_mesh_id, mesh); });
+    }
+
+    // Runs the uploads of finished loads and adds the parts of the app whose assets are ready.
+    void update_assets()
+    {
+        m_assets.process_uploads(AssetUploadBudget);
 
-        NG::Shader particle_shader;
-        particle_shader.set_vertex_source(particle_vertex_shader);
-        particle_shader.set_fragment_source(fragment_shader);
-        if (!m_renderer.load(m_particle_shader_id, particle_shader))
+        if (m_render_system == nullptr && finished(m_shaders_load) && finished(m_mesh_load))
         {
-            throw std::runtime_error("Can't load shader.");
+            add_render_system();
         }
 
-        NG::Shader text_shader;
-        text_shader.set_vertex_source(text_vertex_shader);
-        text_shader.set_fragment_source(fragment_shader);
-        if (!m_renderer.load(m_text_shader_id, text_shader))
+        if (!m_text_ready)
         {
-            throw std::runtime_error("Can't load shader.");
+            // The text overlays are drawn over a background quad from m_mesh_id.
+            m_text_ready = finished(m_shaders_load) && finished(m_font_load) && finished(m_mesh_load);
         }
+    }
 
-        NG::Mesh mesh;
-        mesh.set_vertices(vertices);
-        mesh.add_submesh(indices);
-
-        m_renderer.load(m_mesh_id, mesh);
-
-        m_renderer.set_clear_color(NG::Color(0x2F2F2FFFU));
+    void add_render_system()
+    {
+        const RenderResources resources{.mesh_id = m_mesh_id,
+                                        .shader_id = m_particle_shader_id,
+                                        .batch_mesh_id = m_batch_mesh_id,
+                                        .batch_shader_id = m_batch_shader_id,
+                                        .gpu_mesh_id = m_gpu_mesh_id,
+                                        .gpu_shader_id = m_gpu_shader_id};
+
+        auto render_system = std::make_unique<RenderSystem>(m_renderer, resources, WorldSize);
+        m_render_system = render_system.get();
+        m_render_system->set_view(m_window.size());
+        m_ecs.add_system(std::move(render_system), SystemStage::Render);
     }
 
     void run()
     {
         NP::begin_profiling("Life");
+        Tracer::instance().set_thread_name("main");
         m_window.show();
 
-        m_frame_time = std::chrono::milliseconds(0);
-        m_last_frame_time = std::chrono::steady_clock::now();
+        m_frame_stats.begin_frame();
+        m_fps_text_time = std::chrono::steady_clock::now();
+        m_simulation_time = std::chrono::milliseconds(0);
+        m_last_simulation_time = m_fps_text_time;
+
+        NL::info("Life") << "Simulation step: "
+                         << std::chrono::duration<double, std::milli>(m_simulation_step).count() << " ms";
 
         while (!m_window.should_close())
         {
+            m_profiler.end_frame();
+
             auto s1 = NP::count_scope("loop");
+            auto p1 = m_profiler.scope("loop");
+            Tracer::Scope t1("loop");
             m_window.process_events();
 
             {
-                auto s2 = NP::count_scope("update");
-                m_ecs.update();
-                render_fps();
+                auto p5 = m_profiler.scope("assets");
+                Tracer::Scope t5("assets");
+                update_assets();
+            }
+
+            {
+                auto s2 = NP::count_scope("simulation");
+                auto p2 = m_profiler.scope("simulation");
+                Tracer::Scope t2("simulation");
+                simulate();
+            }
+
+            {
+                auto s3 = NP::count_scope("update");
+                auto p3 = m_profiler.scope("update");
+                Tracer::Scope t3("update");
+                const float alpha = static_cast<float>(m_simulation_time.count()) /
+                                    static_cast<float>(m_simulation_step.count());
+                if (m_render_system != nullptr)
+                {
+                    m_render_system->set_interpolation(alpha);
+                    m_ecs.update(SystemStage::Render);
+                }
+                if (m_text_ready)
+                {
+                    render_fps();
+                    render_profiler();
+                }
             }
 
             {
-                auto s3 = NP::count_scope("display");
+                auto s4 = NP::count_scope("display");
+                auto p4 = m_profiler.scope("display");
+                Tracer::Scope t4("display");
+                m_frame_stats.begin_display();
                 m_renderer.display();
             }
 
@@ -367,6 +536,57 @@ public:
         }
 
         NP::dump_to_file("Life.json");
+        stop_trace();
+    }
+
+    // Continuous trace of the frame and system scopes, see Tracer. The file is rotated at the
+    // tracer's default size, a long session only keeps its latest part.
+    void start_trace(const std::filesystem::path &path)
+    {
+        try
+        {
+            Tracer::instance().start(path);
+            NL::info("Life") << "Tracing to " << path;
+        }
+        catch (const std::runtime_error &e)
+        {
+            NL::error("Life") << e.what();
+        }
+    }
+
+    void stop_trace()
+    {
+        Tracer &tracer = Tracer::instance();
+        if (tracer.running())
+        {
+            tracer.stop();
+            NL::info("Life") << "Trace stopped, " << tracer.dropped_events() << " events dropped";
+        }
+    }
+
+    // Runs as many fixed simulation steps as the real time since the last frame covers. The leftover
+    // time stays in the accumulator and is used by the render to interpolate between the last two states.
+    void simulate()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        m_simulation_time += now - m_last_simulation_time;
+        m_last_simulation_time = now;
+
+        std::size_t steps = 0;
+        while (m_simulation_time >= m_simulation_step)
+        {
+            if (steps == MaxSimulationStepsPerFrame)
+            {
+                // Too far behind (slow frame, debugger, window drag), drop the backlog instead of trying
+                // to catch up and making the next frame even slower.
+                m_simulation_time = std::chrono::milliseconds(0);
+                break;
+            }
+
+            m_ecs.update(SystemStage::Simulation);
+            m_simulation_time -= m_simulation_step;
+            ++steps;
+        }
     }
 
     void on_resize(N::Size size)
@@ -374,23 +594,185 @@ public:
         m_renderer.set_uniform("projectionMatrix",
                                NM::ortho2d<float>(0, static_cast<float>(size.width), 0, static_cast<float>(size.height)));
         m_renderer.set_viewport(size);
+
+        if (m_render_system != nullptr)
+        {
+            m_render_system->set_view(size);
+        }
     }
 
-    void tick()
+    void on_key_up(NS::KeyCode key)
     {
-        const auto now = std::chrono::steady_clock::now();
-        m_last_frame_duration = (now - m_last_frame_time);
-        m_frame_time += m_last_frame_duration;
-        m_last_frame_time = now;
+        // Keys act on the scene, which is not there until its assets have loaded.
+        if (m_render_system == nullptr)
+        {
+            return;
+        }
+
+        if (key == NS::KeyCode::key_equal)
+        {
+            spawn_entities(SpawnStep);
+        }
+        else if (key == NS::KeyCode::key_minus)
+        {
+            despawn_entities(SpawnStep);
+        }
+        else if (key == NS::KeyCode::key_b)
+        {
+            switch (m_render_system->mode())
+            {
+            case RenderMode::UniformArrays:
+                set_render_mode(RenderMode::BatchedMesh);
+                break;
+            case RenderMode::BatchedMesh:
+                set_render_mode(RenderMode::GpuSimulation);
+                break;
+            case RenderMode::GpuSimulation:
+                set_render_mode(RenderMode::UniformArrays);
+                break;
+            }
+        }
+        else if (key == NS::KeyCode::key_p)
+        {
+            m_profiler.set_enabled(!m_profiler.enabled());
+            m_hud_lines.clear();
+        }
+        else if (key == NS::KeyCode::key_f5)
+        {
+            save_state();
+        }
+        else if (key == NS::KeyCode::key_f9)
+        {
+            load_state();
+        }
+        else if (key == NS::KeyCode::key_l)
+        {
+            m_render_system->set_lod_enabled(!m_render_system->lod_enabled());
+        }
+        else if (key == NS::KeyCode::key_c)
+        {
+            m_collisions_enabled = !m_collisions_enabled;
+            set_render_mode(m_render_system->mode());
+        }
+        else if (key == NS::KeyCode::key_t)
+        {
+            if (Tracer::instance().running())
+            {
+                stop_trace();
+            }
+            else
+            {
+                start_trace(TracePath);
+            }
+        }
+    }
+
+    void spawn_entities(std::size_t count)
+    {
+        if (m_render_system != nullptr)
+        {
+            m_render_system->sync_storage();
+        }
+
+        const std::size_t first = m_entities.size();
+        m_entities.resize(first + count);
+
+        const std::uint64_t seed = m_random_seed++;
+        m_ecs.create_entities(
+            count,
+            [seed](std::size_t i,
+                   RenderComponent &r,
+                   SizeComponent &s,
+                   PositionComponent &p,
+                   PreviousPositionComponent &pp,
+                   MovementComponent &m)
+            {
+                CounterRandom random(seed, i);
+
+                const float red = random.uniform(0.2f, 1.0f);
+                const float green = random.uniform(0.2f, 1.0f);
+
+                r.color = NG::Colorf{red, green, green, 1.0f};
+                s.size = NM::Vector2i{random.uniform(10, 20), random.uniform(10, 20)};
+                p.pos = NM::Vector2i{random.uniform(100, 200), random.uniform(100, 200)};
+                pp.pos = p.pos;
+                m.offset = NM::Vector2i{random.uniform(-10, 10), random.uniform(-10, 10)};
+            },
+            std::span(m_entities).subspan(first));
+    }
+
+    void save_state()
+    {
+        m_render_system->sync_storage();
+
+        try
+        {
+            save_snapshot(m_ecs, SnapshotPath);
+            NL::info("Life") << "Saved " << m_ecs.size() << " entities to " << SnapshotPath;
+        }
+        catch (const std::runtime_error &e)
+        {
+            NL::info("Life") << "Can't save snapshot: " << e.what();
+        }
+    }
+
+    void load_state()
+    {
+        m_render_system->sync_storage();
+
+        try
+        {
+            m_entities = load_snapshot(m_ecs, SnapshotPath);
+            NL::info("Life") << "Loaded " << m_entities.size() << " entities from " << SnapshotPath;
+        }
+        catch (const std::runtime_error &e)
+        {
+            NL::info("Life") << "Can't load snapshot: " << e.what();
+        }
+    }
 
-        while (m_frame_time > std::chrono::seconds(1))
+    // Destroys randomly picked entities, so removal happens all over the storage.
+    void despawn_entities(std::size_t count)
+    {
+        m_render_system->sync_storage();
+
+        count = std::min(count, m_entities.size());
+        const auto picks = NU::random_numbers<std::size_t>(0, m_entities.size() - 1, count);
+
+        for (std::size_t i = 0; i < count; ++i)
         {
-            m_frame_time -= std::chrono::seconds(1);
-            m_fps = m_current_fps;
-            m_current_fps = 0;
+            const std::size_t index = picks[i] % m_entities.size();
+
+            m_ecs.destroy_entity(m_entities[index]);
+
+            m_entities[index] = m_entities.back();
+            m_entities.pop_back();
         }
+    }
 
-        m_current_fps++;
+    void set_render_mode(RenderMode mode)
+    {
+        m_render_system->set_mode(mode);
+        m_movement_system->set_enabled(mode != RenderMode::GpuSimulation);
+        m_collision_system->set_enabled(m_collisions_enabled && mode != RenderMode::GpuSimulation);
+    }
+
+    void tick()
+    {
+        m_frame_stats.end_frame();
+
+        // The text changes once per second, a mean frame time would hide the hitches of that
+        // second, so the frame time shown is the p99 over the last FrameStats window.
+        const auto now = m_frame_stats.frame_start();
+        if (now - m_fps_text_time > std::chrono::seconds(1))
+        {
+            m_fps_text_time = now;
+
+            const FrameStats::Summary stats = m_frame_stats.summary();
+            char text[64];
+            std::snprintf(text, sizeof(text), "%u %.2f", stats.fps, stats.p99_ms);
+            m_fps_text = text;
+        }
     }
 
     void render_fps()
@@ -402,50 +784,214 @@ public:
         // back
         m_renderer.render(m_mesh_id,
                           m_text_shader_id,
-                          {NG::Uniform{"pos", NM::Vector3f{size.width - 80, 55, 0.1}},
-                           NG::Uniform{"size", NM::Vector3f{100, 20, 1}},
-                           NG::Uniform{"color", NG::Color(0x020202FFU)}});
+                          {NG::Uniform{PositionUniform, NM::Vector3f{size.width - 80, 55, 0.1}},
+                           NG::Uniform{SizeUniform, NM::Vector3f{100, 20, 1}},
+                           NG::Uniform{ColorUniform, NG::Color(0x020202FFU)}});
 
         // text
         NM::Vector3f text_pos = NM::Vector3f{size.width, 0, 0.15} - FpsTextBottomRightOffset;
 
-        std::string text = std::to_string(m_fps) + " " + std::to_string(m_last_frame_duration.count());
+        m_renderer.render(m_text_cache.get(m_fps_text),
+                          m_text_shader_id,
+                          {NG::Uniform{PositionUniform, text_pos},
+                           NG::Uniform{SizeUniform, normal_text_scale},
+                           NG::Uniform{ColorUniform, NM::Vector4f(0.9f, 0.5f, 0.6f, 1.0f)}});
+    }
+
+    // Profiler overlay: frame and per-scope timings over the profiler history and a frame time
+    // histogram. Text is refreshed a few times per second, so its meshes come from the cache.
+    void render_profiler()
+    {
+        if (!m_profiler.enabled())
+        {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (m_hud_lines.empty() || now - m_hud_refresh_time > HudRefreshInterval)
+        {
+            m_hud_refresh_time = now;
+            update_hud_lines();
+        }
+
+        constexpr float LineHeight = 18.0f;
+        constexpr float Margin = 10.0f;
+        constexpr float BarWidth = 12.0f;
+        constexpr float MaxBarHeight = 60.0f;
+        constexpr NM::Vector3f TextScale = {13, 13, 1};
+
+        const auto size = m_window.size();
+        const float width = 420.0f;
+        const float height = LineHeight * static_cast<float>(m_hud_lines.size()) + MaxBarHeight + 3 * Margin;
+        const float top = static_cast<float>(size.height) - Margin;
 
-        m_renderer.load(m_text_id, m_font.create_text_mesh(text));
-        m_renderer.render(m_text_id,
+        // back
+        m_renderer.render(m_mesh_id,
                           m_text_shader_id,
-                          {NG::Uniform{"pos", text_pos},
-                           NG::Uniform{"size", normal_text_scale},
-                           NG::Uniform{"color", NM::Vector4f(0.9f, 0.5f, 0.6f, 1.0f)}});
+                          {NG::Uniform{PositionUniform, NM::Vector3f{Margin + width * 0.5f, top - height * 0.5f, 0.1}},
+                           NG::Uniform{SizeUniform, NM::Vector3f{width, height, 1}},
+                           NG::Uniform{ColorUniform, NG::Color(0x020202D0U)}});
+
+        // text
+        float y = top - Margin - LineHeight * 0.75f;
+        for (const auto &line : m_hud_lines)
+        {
+            m_renderer.render(m_hud_text_cache.get(line),
+                              m_text_shader_id,
+                              {NG::Uniform{PositionUniform, NM::Vector3f{2 * Margin, y, 0.15}},
+                               NG::Uniform{SizeUniform, TextScale},
+                               NG::Uniform{ColorUniform, NM::Vector4f(0.9f, 0.9f, 0.9f, 1.0f)}});
+            y -= LineHeight;
+        }
+
+        // frame time histogram, one bar per FrameProfiler::HistogramBinMs
+        const auto bins = m_profiler.frame_histogram();
+        const std::size_t max_count = std::max<std::size_t>(*std::max_element(bins.begin(), bins.end()), 1);
+        const float bottom = top - height + Margin;
+
+        for (std::size_t i = 0; i < bins.size(); ++i)
+        {
+            const float bar_height =
+                MaxBarHeight * static_cast<float>(bins[i]) / static_cast<float>(max_count) + 1.0f;
+            const float x = 2 * Margin + (BarWidth + 2.0f) * static_cast<float>(i) + BarWidth * 0.5f;
+
+            m_renderer.render(m_mesh_id,
+                              m_text_shader_id,
+                              {NG::Uniform{PositionUniform, NM::Vector3f{x, bottom + bar_height * 0.5f, 0.15}},
+                               NG::Uniform{SizeUniform, NM::Vector3f{BarWidth, bar_height, 1}},
+                               NG::Uniform{ColorUniform, NM::Vector4f(0.4f, 0.8f, 0.5f, 1.0f)}});
+        }
+    }
+
+    void update_hud_lines()
+    {
+        m_hud_lines.clear();
+
+        char line[128];
+        const auto print = [&line](const std::string &name, std::size_t depth, const FrameProfiler::Stats &stats)
+        {
+            std::snprintf(line,
+                          sizeof(line),
+                          "%*s%-*.*s %6.2f %6.2f %6.2f",
+                          static_cast<int>(depth * 2),
+                          "",
+                          static_cast<int>(24 - depth * 2),
+                          static_cast<int>(24 - depth * 2),
+                          name.c_str(),
+                          stats.mean_ms,
+                          stats.p50_ms,
+                          stats.p99_ms);
+        };
+
+        std::snprintf(line, sizeof(line), "%-24s %6s %6s %6s", "ms", "mean", "p50", "p99");
+        m_hud_lines.emplace_back(line);
+
+        print("frame", 0, m_profiler.frame_stats());
+        m_hud_lines.emplace_back(line);
+
+        std::snprintf(line,
+                      sizeof(line),
+                      "entities %zu drawn %zu%s",
+                      m_ecs.size(),
+                      m_render_system->visible_count(),
+                      m_render_system->lod_enabled() ? " lod" : "");
+        m_hud_lines.emplace_back(line);
+
+        // Children are listed right after their parent, so the tree reads top to bottom.
+        const auto add_children = [this, &print, &line](auto &self, FrameProfiler::ScopeId parent) -> void
+        {
+            for (FrameProfiler::ScopeId id = 0; id < m_profiler.scopes_count(); ++id)
+            {
+                if (m_profiler.parent(id) == parent && m_hud_lines.size() < MaxHudLinesCount)
+                {
+                    print(m_profiler.name(id), std::min<std::size_t>(m_profiler.depth(id), 8), m_profiler.stats(id));
+                    m_hud_lines.emplace_back(line);
+                    self(self, id);
+                }
+            }
+        };
+        add_children(add_children, FrameProfiler::NoScope);
     }
 
 private:
     NS::Window m_window;
     NG::Renderer m_renderer;
+    ShaderLoader m_shaders;
+    NG::Font m_font;
 
+    JobSystem m_jobs;
     ECSType m_ecs;
+    std::vector<Entity> m_entities;
+    std::uint64_t m_random_seed = std::random_device{}();
+    std::size_t m_initial_entities_count;
 
     NG::Renderer::ResourceId m_particle_shader_id = 1;
     NG::Renderer::ResourceId m_text_shader_id = 2;
+    NG::Renderer::ResourceId m_batch_shader_id = 3;
+    NG::Renderer::ResourceId m_gpu_shader_id = 4;
 
     NG::Renderer::ResourceId m_mesh_id = 1;
-    NG::Renderer::ResourceId m_text_id = 2;
+    NG::Renderer::ResourceId m_batch_mesh_id = 3; // and next StreamBuffer::DefaultFramesCount - 1 ids
+    NG::Renderer::ResourceId m_gpu_mesh_id = 6;
+    NG::Renderer::ResourceId m_text_id = 7; // and next TextCache::DefaultSlotsCount - 1 ids
 
-    int m_fps = 0;
-    int m_current_fps = 0;
-    std::chrono::steady_clock::duration m_frame_time;
-    std::chrono::steady_clock::duration m_last_frame_duration;
-    std::chrono::steady_clock::time_point m_last_frame_time;
+    NG::Renderer::ResourceId m_hud_text_id = 11; // and next MaxHudLinesCount - 1 ids
 
-    NG::Font m_font;
+    TextCache m_text_cache;
+    TextCache m_hud_text_cache;
+
+    FrameProfiler m_profiler;
+    std::vector<std::string> m_hud_lines;
+    std::chrono::steady_clock::time_point m_hud_refresh_time;
+
+    RenderSystem *m_render_system = nullptr;
+    MovementSystem *m_movement_system = nullptr;
+    CollisionSystem *m_collision_system = nullptr;
+    bool m_collisions_enabled = false;
+
+    FrameStats m_frame_stats;
+    std::chrono::steady_clock::time_point m_fps_text_time;
+    std::string m_fps_text = "0 0.00";
+
+    std::chrono::steady_clock::duration m_simulation_step;
+    std::chrono::steady_clock::duration m_simulation_time;
+    std::chrono::steady_clock::time_point m_last_simulation_time;
+
+    std::future<void> m_font_load;
+    std::future<void> m_shaders_load;
+    std::future<void> m_mesh_load;
+    bool m_text_ready = false;
+
+    // Last, so the loader thread is stopped before anything it loads into is destroyed.
+    AssetLoader m_assets;
 };
 
-int main()
+// Usage: life [entities count] [simulation rate] [trace file]
+// Defaults are 100000 entities and 60 simulation steps per second, tracing starts at launch
+// when a trace file is given.
+int main(int argc, char *argv[])
 {
     neutrino::log::set_logger(std::make_unique<NL::StreamLogger>(std::cout));
     NL::info("Main") << "RUN";
 
-    App app;
+    std::size_t entities_count = DefaultEntitiesCount;
+    double simulation_rate = DefaultSimulationRate;
+
+    // Rate is in simulation steps per second, the fixed step is its inverse.
+    if ((argc > 1 && !parse_number(argv[1], entities_count)) ||
+        (argc > 2 && (!parse_number(argv[2], simulation_rate) || !(simulation_rate > 0.0) ||
+                      simulation_rate > MaxSimulationRate)))
+    {
+        std::cerr << "Usage: " << argv[0] << " [entities count] [simulation rate in (0, " << MaxSimulationRate
+                  << "]] [trace file]" << std::endl;
+        return 1;
+    }
+
+    App app(entities_count, simulation_rate);
     app.init();
+    if (argc > 3)
+    {
+        app.start_trace(argv[3]);
+    }
     app.run();
 }
@@ -0,0 +1,31 @@
+#ifndef LIFE_MAPPED_FILE_HPP
+#define LIFE_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// Read-only memory mapping of a whole file. Throws std::runtime_error when the file
+// can't be opened or mapped.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const std::byte> data() const;
+
+private:
+    const std::byte* m_data = nullptr;
+    std::size_t m_size = 0;
+
+#if defined(_WIN32)
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include "movement_kernel.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define LIFE_KERNEL_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define LIFE_TARGET(name)
+    #else
+        #define LIFE_TARGET(name) __attribute__((target(name)))
+    #endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+    #define LIFE_KERNEL_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace
+{
+    struct KernelInfo
+    {
+        MovementKernel kernel;
+        const char* name;
+    };
+
+#ifdef LIFE_KERNEL_X86
+
+    // Vectors hold interleaved (x, y) pairs, so bounds alternate width and height.
+    // Division by two is done the way integer division works: rounding towards zero.
+
+    LIFE_TARGET("avx512f")
+    void move_entities_avx512(int* positions, const int* sizes, int* offsets, std::size_t count, int width, int height)
+    {
+        constexpr std::size_t entities_per_step = 8;
+
+        const __m512i bounds = _mm512_set_epi32(height, width, height, width, height, width, height, width,
+                                                height, width, height, width, height, width, height, width);
+        const __m512i zero = _mm512_setzero_si512();
+
+        std::size_t i = 0;
+        for (; i + entities_per_step <= count; i += entities_per_step)
+        {
+            __m512i pos = _mm512_loadu_si512(positions + i * 2);
+            __m512i offset = _mm512_loadu_si512(offsets + i * 2);
+            const __m512i size = _mm512_loadu_si512(sizes + i * 2);
+
+            const __m512i half = _mm512_srai_epi32(_mm512_add_epi32(size, _mm512_srli_epi32(size, 31)), 1);
+
+            const __mmask16 over = _mm512_cmpgt_epi32_mask(_mm512_add_epi32(pos, half), bounds);
+            const __mmask16 under = _mm512_cmpgt_epi32_mask(zero, _mm512_sub_epi32(pos, half));
+
+            offset = _mm512_mask_sub_epi32(offset, over | under, zero, offset);
+            pos = _mm512_add_epi32(pos, offset);
+
+            _mm512_storeu_si512(positions + i * 2, pos);
+            _mm512_storeu_si512(offsets + i * 2, offset);
+        }
+
+        move_entities_scalar(positions + i * 2, sizes + i * 2, offsets + i * 2, count - i, width, height);
+    }
+
+    LIFE_TARGET("avx2")
+    void move_entities_avx2(int* positions, const int* sizes, int* offsets, std::size_t count, int width, int height)
+    {
+        constexpr std::size_t entities_per_step = 4;
+
+        const __m256i bounds = _mm256_set_epi32(height, width, height, width, height, width, height, width);
+        const __m256i zero = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+        for (; i + entities_per_step <= count; i += entities_per_step)
+        {
+            auto* pos_ptr = reinterpret_cast<__m256i*>(positions + i * 2);
+            auto* offset_ptr = reinterpret_cast<__m256i*>(offsets + i * 2);
+
+            __m256i pos = _mm256_loadu_si256(pos_ptr);
+            __m256i offset = _mm256_loadu_si256(offset_ptr);
+            const __m256i size = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sizes + i * 2));
+
+            const __m256i half = _mm256_srai_epi32(_mm256_add_epi32(size, _mm256_srli_epi32(size, 31)), 1);
+
+            const __m256i over = _mm256_cmpgt_epi32(_mm256_add_epi32(pos, half), bounds);
+            const __m256i under = _mm256_cmpgt_epi32(zero, _mm256_sub_epi32(pos, half));
+            const __m256i reflect = _mm256_or_si256(over, under);
+
+            // (offset ^ -1) - (-1) == -offset, lanes with zero mask are left untouched.
+            offset = _mm256_sub_epi32(_mm256_xor_si256(offset, reflect), reflect);
+            pos = _mm256_add_epi32(pos, offset);
+
+            _mm256_storeu_si256(pos_ptr, pos);
+            _mm256_storeu_si256(offset_ptr, offset);
+        }
+
+        move_entities_scalar(positions + i * 2, sizes + i * 2, offsets + i * 2, count - i, width, height);
+    }
+
+    void move_entities_sse2(int* positions, const int* sizes, int* offsets, std::size_t count, int width, int height)
+    {
+        constexpr std::size_t entities_per_step = 2;
+
+        const __m128i bounds = _mm_set_epi32(height, width, height, width);
+        const __m128i zero = _mm_setzero_si128();
+
+        std::size_t i = 0;
+        for (; i + entities_per_step <= count; i += entities_per_step)
+        {
+            auto* pos_ptr = reinterpret_cast<__m128i*>(positions + i * 2);
+            auto* offset_ptr = reinterpret_cast<__m128i*>(offsets + i * 2);
+
+            __m128i pos = _mm_loadu_si128(pos_ptr);
+            __m128i offset = _mm_loadu_si128(offset_ptr);
+            const __m128i size = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sizes + i * 2));
+
+            const __m128i half = _mm_srai_epi32(_mm_add_epi32(size, _mm_srli_epi32(size, 31)), 1);
+
+            const __m128i over = _mm_cmpgt_epi32(_mm_add_epi32(pos, half), bounds);
+            const __m128i under = _mm_cmpgt_epi32(zero, _mm_sub_epi32(pos, half));
+            const __m128i reflect = _mm_or_si128(over, under);
+
+            offset = _mm_sub_epi32(_mm_xor_si128(offset, reflect), reflect);
+            pos = _mm_add_epi32(pos, offset);
+
+            _mm_storeu_si128(pos_ptr, pos);
+            _mm_storeu_si128(offset_ptr, offset);
+        }
+
+        move_entities_scalar(positions + i * 2, sizes + i * 2, offsets + i * 2, count - i, width, height);
+    }
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+    bool cpu_supports(int leaf_7_ebx_bit)
+    {
+        int info[4] = {};
+        __cpuid(info, 1);
+        const bool os_saves_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        if (!os_saves_avx)
+        {
+            return false;
+        }
+
+        if (leaf_7_ebx_bit == 16 && (_xgetbv(0) & 0xE6) != 0xE6)
+        {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << leaf_7_ebx_bit)) != 0;
+    }
+
+    bool has_avx512f()
+    {
+        return cpu_supports(16);
+    }
+
+    bool has_avx2()
+    {
+        return cpu_supports(5);
+    }
+    #else
+    bool has_avx512f()
+    {
+        return __builtin_cpu_supports("avx512f");
+    }
+
+    bool has_avx2()
+    {
+        return __builtin_cpu_supports("avx2");
+    }
+    #endif
+
+    KernelInfo select_kernel()
+    {
+        if (has_avx512f())
+        {
+            return {move_entities_avx512, "avx512"};
+        }
+
+        if (has_avx2())
+        {
+            return {move_entities_avx2, "avx2"};
+        }
+
+        // SSE2 is always present on x86-64.
+        return {move_entities_sse2, "sse2"};
+    }
+
+#elif defined(LIFE_KERNEL_NEON)
+
+    void move_entities_neon(int* positions, const int* sizes, int* offsets, std::size_t count, int width, int height)
+    {
+        constexpr std::size_t entities_per_step = 2;
+
+        const int32_t bounds_data[] = {width, height, width, height};
+        const int32x4_t bounds = vld1q_s32(bounds_data);
+        const int32x4_t zero = vdupq_n_s32(0);
+
+        std::size_t i = 0;
+        for (; i + entities_per_step <= count; i += entities_per_step)
+        {
+            int32x4_t pos = vld1q_s32(positions + i * 2);
+            int32x4_t offset = vld1q_s32(offsets + i * 2);
+            const int32x4_t size = vld1q_s32(sizes + i * 2);
+
+            const int32x4_t sign = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(size), 31));
+            const int32x4_t half = vshrq_n_s32(vaddq_s32(size, sign), 1);
+
+            const uint32x4_t over = vcgtq_s32(vaddq_s32(pos, half), bounds);
+            const uint32x4_t under = vcltq_s32(vsubq_s32(pos, half), zero);
+            const uint32x4_t reflect = vorrq_u32(over, under);
+
+            offset = vbslq_s32(reflect, vnegq_s32(offset), offset);
+            pos = vaddq_s32(pos, offset);
+
+            vst1q_s32(positions + i * 2, pos);
+            vst1q_s32(offsets + i * 2, offset);
+        }
+
+        move_entities_scalar(positions + i * 2, sizes + i * 2, offsets + i * 2, count - i, width, height);
+    }
+
+    KernelInfo select_kernel()
+    {
+        return {move_entities_neon, "neon"};
+    }
+
+#else
+
+    KernelInfo select_kernel()
+    {
+        return {move_entities_scalar, "scalar"};
+    }
+
+#endif
+
+    const KernelInfo& kernel_info()
+    {
+        static const KernelInfo info = select_kernel();
+        return info;
+    }
+
+} // namespace
+
+MovementKernel movement_kernel()
+{
+    return kernel_info().kernel;
+}
+
+const char* movement_kernel_name()
+{
+    return kernel_info().name;
+}
+
+void move_entities_scalar(int* positions, const int* sizes, int* offsets, std::size_t count, int width, int height)
+{
+    for (std::size_t i = 0; i < count * 2; i += 2)
+    {
+        int* pos = positions + i;
+        int* offset = offsets + i;
+        const int* size = sizes + i;
+
+        if (pos[0] + size[0] / 2 > width || pos[0] - size[0] / 2 < 0)
+        {
+            offset[0] *= -1;
+        }
+
+        if (pos[1] + size[1] / 2 > height || pos[1] - size[1] / 2 < 0)
+        {
+            offset[1] *= -1;
+        }
+
+        pos[0] += offset[0];
+        pos[1] += offset[1];
+    }
+}
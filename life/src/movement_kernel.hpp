@@ -0,0 +1,22 @@
+#ifndef LIFE_MOVEMENT_KERNEL_HPP
+#define LIFE_MOVEMENT_KERNEL_HPP
+
+#include <cstddef>
+
+// Moves count entities and reflects them from the walls of the [0, width] x [0, height] box.
+//
+// positions, sizes and offsets are arrays of count interleaved (x, y) pairs. An entity whose
+// center is closer than half of its size to a wall gets its offset along that axis negated
+// before the offset is added to its position.
+using MovementKernel = void (*)(int* positions, const int* sizes, int* offsets, std::size_t count, int width, int height);
+
+// Best kernel for the current CPU, selected once at first call.
+MovementKernel movement_kernel();
+
+// Name of the kernel returned by movement_kernel().
+const char* movement_kernel_name();
+
+// Reference implementation, used for tails and on CPUs without vector extensions.
+void move_entities_scalar(int* positions, const int* sizes, int* offsets, std::size_t count, int width, int height);
+
+#endif
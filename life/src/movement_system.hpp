@@ -0,0 +1,68 @@
+#ifndef LIFE_MOVEMENT_SYSTEM_HPP
+#define LIFE_MOVEMENT_SYSTEM_HPP
+
+#include <algorithm>
+
+#include <common/size.hpp>
+
+#include "components.hpp"
+#include "ecs.hpp"
+#include "movement_kernel.hpp"
+
+// Moves entities by their offset and reflects them from the world bounds. Chunks are
+// processed in parallel by the best movement kernel the CPU supports.
+template <typename StorageType>
+class BasicMovementSystem : public StorageType::SystemType
+{
+public:
+    BasicMovementSystem(neutrino::Size size)
+        : m_size(size)
+    {
+    }
+
+    ComponentAccess access() const override
+    {
+        return {.reads = StorageType::template components_mask<SizeComponent>(),
+                .writes = StorageType::template components_mask<PositionComponent,
+                                                                PreviousPositionComponent,
+                                                                MovementComponent>()};
+    }
+
+    void update() override
+    {
+        auto &storage = this->storage();
+        storage.parallel_for_chunks(
+            [this, &storage](typename StorageType::ChunkType &chunk)
+            {
+                update_chunk(chunk);
+                storage.template mark_changed<PositionComponent, PreviousPositionComponent, MovementComponent>(chunk);
+            });
+    }
+
+private:
+    void update_chunk(typename StorageType::ChunkType &chunk) const
+    {
+        static_assert(sizeof(PositionComponent) == 2 * sizeof(int) && sizeof(SizeComponent) == 2 * sizeof(int) &&
+                          sizeof(MovementComponent) == 2 * sizeof(int),
+                      "Movement kernel expects tightly packed (x, y) int pairs");
+
+        std::transform(chunk.template data<PositionComponent>(),
+                       chunk.template data<PositionComponent>() + chunk.size(),
+                       chunk.template data<PreviousPositionComponent>(),
+                       [](const PositionComponent &p) { return PreviousPositionComponent{p.pos}; });
+
+        m_kernel(reinterpret_cast<int *>(chunk.template data<PositionComponent>()),
+                 reinterpret_cast<const int *>(chunk.template data<SizeComponent>()),
+                 reinterpret_cast<int *>(chunk.template data<MovementComponent>()),
+                 chunk.size(),
+                 m_size.width,
+                 m_size.height);
+    }
+
+    MovementKernel m_kernel = movement_kernel();
+    neutrino::Size m_size;
+};
+
+using MovementSystem = BasicMovementSystem<ECSType>;
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef LIFE_QUAD_BATCH_HPP
+#define LIFE_QUAD_BATCH_HPP
+
+#include <cstddef>
+#include <span>
+
+#include <graphics/color.hpp>
+#include <math/math.hpp>
+
+#include "components.hpp"
+#include "view_culling.hpp"
+
+// Point between two simulation states, alpha is in [0, 1].
+inline neutrino::math::Vector2f interpolate(neutrino::math::Vector2i from, neutrino::math::Vector2i to, float alpha)
+{
+    return neutrino::math::Vector2f{static_cast<float>(from.x) + static_cast<float>(to.x - from.x) * alpha,
+                                    static_cast<float>(from.y) + static_cast<float>(to.y - from.y) * alpha};
+}
+
+// Writes one quad per entity, four vertices and colors each, at positions interpolated
+// between the last two simulation states. With culling set only quads it accepts are written,
+// packed at the beginning of the buffers. Colors are left untouched when the colors span is
+// empty. Returns the number of quads written.
+template <typename StorageType>
+std::size_t write_quads(StorageType &storage,
+                        float alpha,
+                        std::span<neutrino::math::Vector3f> vertices,
+                        std::span<neutrino::graphics::Color> colors,
+                        ViewCulling *culling = nullptr)
+{
+    const auto entities = storage.template view<const PositionComponent,
+                                                const PreviousPositionComponent,
+                                                const SizeComponent,
+                                                const RenderComponent>();
+
+    constexpr std::size_t QuadVerticesCount = 4;
+
+    std::size_t index = 0;
+    for (const auto [p, pp, s, r] : entities)
+    {
+        const neutrino::math::Vector2f pos = interpolate(pp.pos, p.pos, alpha);
+
+        const float left = pos.x - static_cast<float>(s.size.x) * 0.5f;
+        const float right = pos.x + static_cast<float>(s.size.x) * 0.5f;
+        const float bottom = pos.y - static_cast<float>(s.size.y) * 0.5f;
+        const float top = pos.y + static_cast<float>(s.size.y) * 0.5f;
+
+        if (culling != nullptr && !culling->visible(left, bottom, right, top))
+        {
+            continue;
+        }
+
+        const std::size_t vertex = index * QuadVerticesCount;
+        vertices[vertex + 0] = neutrino::math::Vector3f{left, bottom, 0};
+        vertices[vertex + 1] = neutrino::math::Vector3f{right, bottom, 0};
+        vertices[vertex + 2] = neutrino::math::Vector3f{right, top, 0};
+        vertices[vertex + 3] = neutrino::math::Vector3f{left, top, 0};
+
+        if (!colors.empty())
+        {
+            const neutrino::graphics::Color color(r.color);
+            for (std::size_t i = 0; i < QuadVerticesCount; ++i)
+            {
+                colors[vertex + i] = color;
+            }
+        }
+
+        ++index;
+    }
+
+    return index;
+}
+
+#endif
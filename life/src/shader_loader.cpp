@@ -0,0 +1,57 @@
+#include "shader_loader.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <graphics/shader.hpp>
+
+namespace NG = neutrino::graphics;
+
+ShaderLoader::ShaderLoader(NG::Renderer& renderer)
+    : m_renderer(renderer)
+{
+}
+
+void ShaderLoader::load(ResourceId id, const std::filesystem::path& vertex, const std::filesystem::path& fragment)
+{
+    NG::Shader shader;
+    shader.set_vertex_source(source(vertex));
+    shader.set_fragment_source(source(fragment));
+    if (!m_renderer.load(id, shader))
+    {
+        throw std::runtime_error("Can't load shader " + vertex.string() + ", " + fragment.string());
+    }
+}
+
+void ShaderLoader::add_source(const std::filesystem::path& path, std::string text)
+{
+    m_sources.insert_or_assign(key_of(path), std::move(text));
+}
+
+std::string ShaderLoader::read_source(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Can't read shader " + path.string());
+    }
+
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+std::string ShaderLoader::key_of(const std::filesystem::path& path)
+{
+    return path.lexically_normal().generic_string();
+}
+
+const std::string& ShaderLoader::source(const std::filesystem::path& path)
+{
+    std::string key = key_of(path);
+    if (const auto it = m_sources.find(key); it != m_sources.end())
+    {
+        return it->second;
+    }
+
+    return m_sources.emplace(std::move(key), read_source(path)).first->second;
+}
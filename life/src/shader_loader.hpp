@@ -0,0 +1,42 @@
+#ifndef LIFE_SHADER_LOADER_HPP
+#define LIFE_SHADER_LOADER_HPP
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include <graphics/renderer.hpp>
+
+// Loads shader programs into the renderer, reading every source file only once.
+//
+// Source files are shared by several programs, so they are read once and kept. Programs
+// themselves are not deduplicated: the renderer owns the program objects and can't persist
+// their binaries, and the app loads no program twice, so there is nothing to reuse yet.
+class ShaderLoader
+{
+public:
+    using ResourceId = neutrino::graphics::Renderer::ResourceId;
+
+    explicit ShaderLoader(neutrino::graphics::Renderer& renderer);
+
+    // Compiles the program into id. Throws std::runtime_error when a source can't be read or
+    // the program fails to load.
+    void load(ResourceId id, const std::filesystem::path& vertex, const std::filesystem::path& fragment);
+
+    // Makes a source read elsewhere, e.g. on a loader thread, available to load().
+    void add_source(const std::filesystem::path& path, std::string text);
+
+    // Reads a source file, throws std::runtime_error when it can't. Does not touch the loaded
+    // sources, so it is safe to call from any thread.
+    static std::string read_source(const std::filesystem::path& path);
+
+private:
+    static std::string key_of(const std::filesystem::path& path);
+
+    const std::string& source(const std::filesystem::path& path);
+
+    neutrino::graphics::Renderer& m_renderer;
+    std::unordered_map<std::string, std::string> m_sources;
+};
+
+#endif
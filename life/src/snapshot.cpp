@@ -0,0 +1,49 @@
+#include "snapshot.hpp"
+
+#include <string>
+
+const SnapshotHeader& validate_snapshot(std::span<const std::byte> data, std::span<const std::uint32_t> component_sizes)
+{
+    if (data.size() < sizeof(SnapshotHeader))
+    {
+        throw std::runtime_error("Snapshot is too small");
+    }
+
+    // The mapping is page aligned, so the header can be used in place.
+    const auto& header = *reinterpret_cast<const SnapshotHeader*>(data.data());
+
+    if (header.magic != SnapshotHeader::Magic)
+    {
+        throw std::runtime_error("Not a snapshot file");
+    }
+
+    if (header.version != SnapshotHeader::CurrentVersion)
+    {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(header.version));
+    }
+
+    if (header.components_count != component_sizes.size())
+    {
+        throw std::runtime_error("Snapshot has " + std::to_string(header.components_count) +
+                                 " component types, storage has " + std::to_string(component_sizes.size()));
+    }
+
+    for (std::size_t i = 0; i < component_sizes.size(); ++i)
+    {
+        if (header.component_sizes[i] != component_sizes[i])
+        {
+            throw std::runtime_error("Snapshot component " + std::to_string(i) + " has size " +
+                                     std::to_string(header.component_sizes[i]) + ", expected " +
+                                     std::to_string(component_sizes[i]));
+        }
+
+        // Compared as a count of items, the column size of a corrupt header could wrap around.
+        if (header.column_offsets[i] % SnapshotAlignment != 0 || header.column_offsets[i] > data.size() ||
+            header.entities_count > (data.size() - header.column_offsets[i]) / header.component_sizes[i])
+        {
+            throw std::runtime_error("Snapshot column " + std::to_string(i) + " is outside of the file");
+        }
+    }
+
+    return header;
+}
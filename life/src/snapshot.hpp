@@ -0,0 +1,130 @@
+#ifndef LIFE_SNAPSHOT_HPP
+#define LIFE_SNAPSHOT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "ecs.hpp"
+#include "mapped_file.hpp"
+
+// Binary snapshot of all components of a storage.
+//
+// File layout: SnapshotHeader, then one column per component type in storage order, each
+// holding the components of all entities in dense order and starting at a SnapshotAlignment
+// aligned offset. Loading maps the file and copies columns straight into the chunks, nothing
+// is parsed. Entity handles are not stored, loaded entities get new ones.
+struct SnapshotHeader
+{
+    static constexpr std::array<char, 8> Magic = {'L', 'I', 'F', 'E', 'S', 'N', 'A', 'P'};
+    static constexpr std::uint32_t CurrentVersion = 1;
+    static constexpr std::size_t MaxComponentsCount = 16;
+
+    std::array<char, 8> magic = Magic;
+    std::uint32_t version = CurrentVersion;
+    std::uint32_t components_count = 0;
+    std::uint64_t entities_count = 0;
+    std::array<std::uint32_t, MaxComponentsCount> component_sizes{};
+    std::array<std::uint64_t, MaxComponentsCount> column_offsets{};
+};
+
+inline constexpr std::size_t SnapshotAlignment = 64;
+
+// Header of a mapped snapshot after checking it matches the given component sizes and
+// that all columns are inside the file. Throws std::runtime_error otherwise.
+const SnapshotHeader& validate_snapshot(std::span<const std::byte> data,
+                                        std::span<const std::uint32_t> component_sizes);
+
+template <std::size_t ChunkSize, typename... Types>
+void save_snapshot(const BasicECS<ChunkSize, Types...>& storage, const std::filesystem::path& path)
+{
+    static_assert((std::is_trivially_copyable_v<Types> && ...), "Snapshot components must be trivially copyable");
+    static_assert(sizeof...(Types) <= SnapshotHeader::MaxComponentsCount, "Too many components for a snapshot");
+
+    SnapshotHeader header;
+    header.components_count = sizeof...(Types);
+    header.entities_count = storage.size();
+    header.component_sizes = {static_cast<std::uint32_t>(sizeof(Types))...};
+
+    std::uint64_t offset = sizeof(SnapshotHeader);
+    for (std::size_t i = 0; i < sizeof...(Types); ++i)
+    {
+        offset = (offset + SnapshotAlignment - 1) / SnapshotAlignment * SnapshotAlignment;
+        header.column_offsets[i] = offset;
+        offset += header.component_sizes[i] * header.entities_count;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Can't create " + path.string());
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::size_t column = 0;
+    const auto write_column = [&]<typename T>()
+    {
+        static constexpr char padding[SnapshotAlignment] = {};
+        const auto position = static_cast<std::uint64_t>(file.tellp());
+        file.write(padding, static_cast<std::streamsize>(header.column_offsets[column] - position));
+
+        for (std::size_t c = 0; c < storage.chunks_count(); ++c)
+        {
+            const auto components = storage.chunk(c).template components<T>();
+            file.write(reinterpret_cast<const char*>(components.data()),
+                       static_cast<std::streamsize>(components.size_bytes()));
+        }
+
+        ++column;
+    };
+    (write_column.template operator()<Types>(), ...);
+
+    if (!file)
+    {
+        throw std::runtime_error("Can't write " + path.string());
+    }
+}
+
+// Replaces all entities of the storage with the ones from the snapshot, returns their handles
+// in dense order.
+template <std::size_t ChunkSize, typename... Types>
+std::vector<Entity> load_snapshot(BasicECS<ChunkSize, Types...>& storage, const std::filesystem::path& path)
+{
+    static_assert((std::is_trivially_copyable_v<Types> && ...), "Snapshot components must be trivially copyable");
+
+    const MappedFile file(path);
+
+    constexpr std::array<std::uint32_t, sizeof...(Types)> sizes = {static_cast<std::uint32_t>(sizeof(Types))...};
+    const SnapshotHeader& header = validate_snapshot(file.data(), sizes);
+
+    const std::byte* data = file.data().data();
+    std::array<const std::byte*, sizeof...(Types)> columns{};
+    for (std::size_t i = 0; i < columns.size(); ++i)
+    {
+        columns[i] = data + header.column_offsets[i];
+    }
+
+    storage.clear();
+
+    std::vector<Entity> handles(header.entities_count);
+    storage.create_entities(
+        handles.size(),
+        [&columns](std::size_t i, Types&... components)
+        {
+            std::size_t column = 0;
+            ((std::memcpy(&components, columns[column++] + i * sizeof(Types), sizeof(Types))), ...);
+        },
+        handles);
+
+    return handles;
+}
+
+#endif
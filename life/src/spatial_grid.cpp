@@ -0,0 +1,85 @@
+#include "spatial_grid.hpp"
+
+SpatialGrid::SpatialGrid(neutrino::Size bounds, int cell_size)
+    : m_cell_size(std::max(cell_size, 1)),
+      m_columns(static_cast<std::size_t>(std::max((bounds.width + m_cell_size - 1) / m_cell_size, 1))),
+      m_rows(static_cast<std::size_t>(std::max((bounds.height + m_cell_size - 1) / m_cell_size, 1))),
+      m_cell_starts(m_columns * m_rows + 1, 0)
+{
+}
+
+std::span<const SpatialGrid::Entry> SpatialGrid::entries() const
+{
+    return {m_entries.data(), m_cell_starts.back()};
+}
+
+std::span<const SpatialGrid::Entry> SpatialGrid::cell(std::size_t index) const
+{
+    return {m_entries.data() + m_cell_starts[index], m_cell_starts[index + 1] - m_cell_starts[index]};
+}
+
+std::size_t SpatialGrid::cells_count() const
+{
+    return m_columns * m_rows;
+}
+
+int SpatialGrid::cell_size() const
+{
+    return m_cell_size;
+}
+
+// Positions outside of the bounds go to the border cells.
+std::size_t SpatialGrid::column_of(int x) const
+{
+    return static_cast<std::size_t>(std::clamp(x / m_cell_size, 0, static_cast<int>(m_columns) - 1));
+}
+
+std::size_t SpatialGrid::row_of(int y) const
+{
+    return static_cast<std::size_t>(std::clamp(y / m_cell_size, 0, static_cast<int>(m_rows) - 1));
+}
+
+std::size_t SpatialGrid::cell_of(int x, int y) const
+{
+    return row_of(y) * m_columns + column_of(x);
+}
+
+void SpatialGrid::prepare(std::size_t entities_count, std::size_t blocks_count)
+{
+    m_blocks_count = blocks_count;
+
+    if (m_entries.size() < entities_count)
+    {
+        m_entries.resize(entities_count);
+        m_entity_cells.resize(entities_count);
+    }
+
+    m_block_offsets.assign(blocks_count * cells_count(), 0);
+    m_block_reaches.assign(blocks_count, 0);
+}
+
+void SpatialGrid::compute_offsets()
+{
+    const std::size_t cells = cells_count();
+
+    // Cell-major order: all entries of a cell come before the next cell, and inside a cell
+    // blocks keep their storage order.
+    std::uint32_t offset = 0;
+    for (std::size_t cell = 0; cell < cells; ++cell)
+    {
+        m_cell_starts[cell] = offset;
+        for (std::size_t block = 0; block < m_blocks_count; ++block)
+        {
+            const std::uint32_t count = m_block_offsets[block * cells + cell];
+            m_block_offsets[block * cells + cell] = offset;
+            offset += count;
+        }
+    }
+    m_cell_starts[cells] = offset;
+
+    m_reach = 0;
+    for (const int reach : m_block_reaches)
+    {
+        m_reach = std::max(m_reach, reach);
+    }
+}
@@ -0,0 +1,173 @@
+#ifndef LIFE_SPATIAL_GRID_HPP
+#define LIFE_SPATIAL_GRID_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <common/size.hpp>
+#include <math/math.hpp>
+
+#include "components.hpp"
+#include "job_system.hpp"
+
+// Uniform grid over the world bounds for broad-phase neighbor queries.
+//
+// Entities are bucketed by the cell of their center with a counting sort, so a rebuild is
+// linear in the entity count and entries of one cell are contiguous. Rebuild splits the
+// storage into blocks of chunks: blocks are counted and scattered in parallel, only the
+// prefix sum over the per-block cell counts is serial. Buffers only grow, a rebuild of the
+// same population does not allocate.
+class SpatialGrid
+{
+public:
+    // Entity box snapshot taken at rebuild, so queries do not touch the storage.
+    struct Entry
+    {
+        std::uint32_t index = 0; // dense index in the storage
+        neutrino::math::Vector2i min;
+        neutrino::math::Vector2i max;
+    };
+
+    static constexpr int DefaultCellSize = 32;
+    static constexpr std::size_t MaxBlocksCount = 64;
+
+    explicit SpatialGrid(neutrino::Size bounds, int cell_size = DefaultCellSize);
+
+    // Rebuilds the grid from positions and sizes of all entities, uses jobs when it is set.
+    template <typename StorageType>
+    void rebuild(const StorageType& storage, JobSystem* jobs);
+
+    // Calls function(const Entry&) for every entity whose box overlaps box [min, max].
+    template <typename Function>
+    void query(neutrino::math::Vector2i min, neutrino::math::Vector2i max, Function&& function) const;
+
+    // Entries sorted by cell, entries of one cell are in storage order.
+    std::span<const Entry> entries() const;
+    std::span<const Entry> cell(std::size_t index) const;
+
+    std::size_t cells_count() const;
+    int cell_size() const;
+
+private:
+    std::size_t column_of(int x) const;
+    std::size_t row_of(int y) const;
+    std::size_t cell_of(int x, int y) const;
+
+    // Sizes the buffers and clears the per-block counts.
+    void prepare(std::size_t entities_count, std::size_t blocks_count);
+
+    // Turns per-block cell counts into scatter offsets and fills cell starts.
+    void compute_offsets();
+
+    template <typename StorageType, typename Function>
+    void for_each_block(const StorageType& storage, JobSystem* jobs, Function&& function);
+
+    int m_cell_size;
+    std::size_t m_columns;
+    std::size_t m_rows;
+
+    std::vector<Entry> m_entries;
+    std::vector<std::uint32_t> m_cell_starts;    // cells_count + 1
+    std::vector<std::uint32_t> m_entity_cells;   // by dense index
+    std::vector<std::uint32_t> m_block_offsets;  // blocks_count * cells_count
+    std::vector<int> m_block_reaches;            // blocks_count
+    std::size_t m_blocks_count = 0;
+
+    // Largest distance from an entity center to its box edge, extends the cells a query looks at.
+    int m_reach = 0;
+};
+
+template <typename StorageType, typename Function>
+void SpatialGrid::for_each_block(const StorageType& storage, JobSystem* jobs, Function&& function)
+{
+    const std::size_t chunks_count = storage.chunks_count();
+
+    const auto job = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t block = begin; block < end; ++block)
+        {
+            const std::size_t first_chunk = block * chunks_count / m_blocks_count;
+            const std::size_t last_chunk = (block + 1) * chunks_count / m_blocks_count;
+
+            for (std::size_t c = first_chunk; c < last_chunk; ++c)
+            {
+                const auto& chunk = storage.chunk(c);
+                const auto positions = chunk.template components<PositionComponent>();
+                const auto sizes = chunk.template components<SizeComponent>();
+                const std::size_t first_index = c * StorageType::ChunkCapacity;
+
+                for (std::size_t i = 0; i < positions.size(); ++i)
+                {
+                    function(block, first_index + i, positions[i].pos, sizes[i].size);
+                }
+            }
+        }
+    };
+
+    if (jobs == nullptr || m_blocks_count < 2)
+    {
+        job(0, m_blocks_count);
+    }
+    else
+    {
+        jobs->parallel_for(m_blocks_count, 1, job);
+    }
+}
+
+template <typename StorageType>
+void SpatialGrid::rebuild(const StorageType& storage, JobSystem* jobs)
+{
+    prepare(storage.size(), std::min(storage.chunks_count(), MaxBlocksCount));
+
+    const std::size_t cells = cells_count();
+
+    for_each_block(storage,
+                   jobs,
+                   [this, cells](std::size_t block, std::size_t index, neutrino::math::Vector2i pos, neutrino::math::Vector2i size)
+                   {
+                       const auto cell = static_cast<std::uint32_t>(cell_of(pos.x, pos.y));
+                       m_entity_cells[index] = cell;
+                       ++m_block_offsets[block * cells + cell];
+                       m_block_reaches[block] = std::max({m_block_reaches[block], size.x - size.x / 2, size.y - size.y / 2});
+                   });
+
+    compute_offsets();
+
+    for_each_block(storage,
+                   jobs,
+                   [this, cells](std::size_t block, std::size_t index, neutrino::math::Vector2i pos, neutrino::math::Vector2i size)
+                   {
+                       const std::uint32_t slot = m_block_offsets[block * cells + m_entity_cells[index]]++;
+                       m_entries[slot] = Entry{.index = static_cast<std::uint32_t>(index),
+                                               .min = {pos.x - size.x / 2, pos.y - size.y / 2},
+                                               .max = {pos.x + (size.x - size.x / 2), pos.y + (size.y - size.y / 2)}};
+                   });
+}
+
+template <typename Function>
+void SpatialGrid::query(neutrino::math::Vector2i min, neutrino::math::Vector2i max, Function&& function) const
+{
+    const std::size_t first_column = column_of(min.x - m_reach);
+    const std::size_t last_column = column_of(max.x + m_reach);
+    const std::size_t first_row = row_of(min.y - m_reach);
+    const std::size_t last_row = row_of(max.y + m_reach);
+
+    for (std::size_t row = first_row; row <= last_row; ++row)
+    {
+        for (std::size_t column = first_column; column <= last_column; ++column)
+        {
+            for (const Entry& entry : cell(row * m_columns + column))
+            {
+                if (entry.min.x <= max.x && entry.max.x >= min.x && entry.min.y <= max.y && entry.max.y >= min.y)
+                {
+                    function(entry);
+                }
+            }
+        }
+    }
+}
+
+#endif
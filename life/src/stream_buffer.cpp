@@ -0,0 +1,116 @@
+#include "stream_buffer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace NG = neutrino::graphics;
+namespace NM = neutrino::math;
+
+namespace
+{
+    constexpr std::size_t MinQuadsCapacity = 1024;
+
+    constexpr std::uint32_t QuadIndices[] = {0, 1, 2, 0, 2, 3};
+}
+
+StreamBuffer::StreamBuffer(NG::Renderer& renderer, ResourceId first_mesh_id, std::size_t frames_count)
+    : m_renderer(renderer), m_slots(std::max<std::size_t>(frames_count, 1))
+{
+    for (std::size_t i = 0; i < m_slots.size(); ++i)
+    {
+        m_slots[i].mesh_id = first_mesh_id + static_cast<ResourceId>(i);
+    }
+
+    m_current = m_slots.size() - 1;
+}
+
+void StreamBuffer::begin_frame(std::size_t quads_count)
+{
+    m_current = (m_current + 1) % m_slots.size();
+    m_quads_count = quads_count;
+
+    Slot& slot = m_slots[m_current];
+    if (slot.capacity < quads_count)
+    {
+        reserve(slot, quads_count);
+    }
+}
+
+std::span<NM::Vector3f> StreamBuffer::vertices()
+{
+    return {m_slots[m_current].vertices.data(), m_quads_count * QuadVerticesCount};
+}
+
+std::span<NG::Color> StreamBuffer::colors()
+{
+    return {m_slots[m_current].colors.data(), m_quads_count * QuadVerticesCount};
+}
+
+void StreamBuffer::submit(ResourceId shader_id)
+{
+    Slot& slot = m_slots[m_current];
+    if (m_quads_count == 0)
+    {
+        return;
+    }
+
+    const auto used_vertices = static_cast<std::ptrdiff_t>(m_quads_count * QuadVerticesCount);
+
+    if (slot.indexed != m_quads_count)
+    {
+        const auto used_indices = static_cast<std::ptrdiff_t>(m_quads_count * std::size(QuadIndices));
+
+        slot.mesh = NG::Mesh();
+        slot.mesh.add_submesh(NG::Mesh::IndicesData(slot.indices.begin(), slot.indices.begin() + used_indices));
+        slot.indexed = m_quads_count;
+    }
+
+    slot.mesh.set_vertices(NG::Mesh::VertexData(slot.vertices.begin(), slot.vertices.begin() + used_vertices));
+    slot.mesh.set_colors(NG::Mesh::ColorData(slot.colors.begin(), slot.colors.begin() + used_vertices));
+
+    m_renderer.load(slot.mesh_id, slot.mesh);
+    m_renderer.render(slot.mesh_id, shader_id);
+}
+
+void StreamBuffer::submit(ResourceId shader_id, std::size_t quads_count)
+{
+    m_quads_count = std::min(m_quads_count, quads_count);
+    submit(shader_id);
+}
+
+std::uint64_t StreamBuffer::colors_version() const
+{
+    return m_slots[m_current].colors_version;
+}
+
+void StreamBuffer::set_colors_version(std::uint64_t version)
+{
+    m_slots[m_current].colors_version = version;
+}
+
+std::size_t StreamBuffer::frames_count() const
+{
+    return m_slots.size();
+}
+
+void StreamBuffer::reserve(Slot& slot, std::size_t quads_count)
+{
+    slot.capacity = std::bit_ceil(std::max(quads_count, MinQuadsCapacity));
+    slot.indexed = 0;
+    slot.colors_version = 0;
+
+    slot.vertices.assign(slot.capacity * QuadVerticesCount, NM::Vector3f{});
+    slot.colors.assign(slot.capacity * QuadVerticesCount, NG::Color());
+
+    slot.indices.clear();
+    slot.indices.reserve(slot.capacity * std::size(QuadIndices));
+    for (std::size_t quad = 0; quad < slot.capacity; ++quad)
+    {
+        const auto first_vertex = static_cast<std::uint32_t>(quad * QuadVerticesCount);
+        for (const auto i : QuadIndices)
+        {
+            slot.indices.push_back(first_vertex + i);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef LIFE_STREAM_BUFFER_HPP
+#define LIFE_STREAM_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <graphics/color.hpp>
+#include <graphics/mesh.hpp>
+#include <graphics/renderer.hpp>
+#include <math/math.hpp>
+
+// Streams per-frame quad geometry to the renderer through a ring of mesh resources.
+//
+// Every slot owns its own mesh resource, so the frame that is written now never reloads
+// the buffer the GPU may still be reading for one of the previous frames. Slot staging
+// storage only grows and is written in place.
+//
+// Only the used quads are uploaded and drawn. Renderer::load always uploads the whole
+// mesh and Mesh takes its attributes by value, so every submit still copies the used
+// vertices into the mesh and sends the index buffer along with them; the framework has no
+// partial update or draw range to avoid that. The index submesh itself is only rebuilt
+// when the quads count of the slot changes.
+class StreamBuffer
+{
+public:
+    using ResourceId = neutrino::graphics::Renderer::ResourceId;
+
+    static constexpr std::size_t DefaultFramesCount = 3;
+    static constexpr std::size_t QuadVerticesCount = 4;
+
+    // Slots use resource ids in range [first_mesh_id, first_mesh_id + frames_count).
+    StreamBuffer(neutrino::graphics::Renderer& renderer,
+                 ResourceId first_mesh_id,
+                 std::size_t frames_count = DefaultFramesCount);
+
+    // Selects the next slot and makes room for quads_count quads in it.
+    void begin_frame(std::size_t quads_count);
+
+    // Write access to the current slot, QuadVerticesCount entries per quad.
+    std::span<neutrino::math::Vector3f> vertices();
+    std::span<neutrino::graphics::Color> colors();
+
+    // Uploads the current slot and draws it with the given shader.
+    void submit(ResourceId shader_id);
+
+    // Same, but only the first quads_count quads of the frame were written.
+    void submit(ResourceId shader_id, std::size_t quads_count);
+
+    // Colors stay in a slot from the last frame that used it. The caller tags them with the
+    // version of the data they were written from and skips rewriting them while it matches.
+    // 0 means the slot colors are not valid, slots start that way.
+    std::uint64_t colors_version() const;
+    void set_colors_version(std::uint64_t version);
+
+    std::size_t frames_count() const;
+
+private:
+    struct Slot
+    {
+        ResourceId mesh_id = 0;
+        neutrino::graphics::Mesh mesh;
+        neutrino::graphics::Mesh::VertexData vertices;
+        neutrino::graphics::Mesh::ColorData colors;
+        neutrino::graphics::Mesh::IndicesData indices;
+        std::size_t capacity = 0;
+        std::size_t indexed = 0;
+        std::uint64_t colors_version = 0;
+    };
+
+    void reserve(Slot& slot, std::size_t quads_count);
+
+    neutrino::graphics::Renderer& m_renderer;
+    std::vector<Slot> m_slots;
+    std::size_t m_current = 0;
+    std::size_t m_quads_count = 0;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "text_cache.hpp"
+
+#include <algorithm>
+
+namespace NG = neutrino::graphics;
+
+TextCache::TextCache(NG::Renderer& renderer, const NG::Font& font, ResourceId first_mesh_id, std::size_t slots_count)
+    : m_renderer(renderer), m_font(font), m_slots(std::max<std::size_t>(slots_count, 1))
+{
+    for (std::size_t i = 0; i < m_slots.size(); ++i)
+    {
+        m_slots[i].mesh_id = first_mesh_id + static_cast<ResourceId>(i);
+    }
+}
+
+TextCache::ResourceId TextCache::get(std::string_view text)
+{
+    ++m_use_counter;
+
+    for (Slot& slot : m_slots)
+    {
+        if (slot.loaded && slot.text == text)
+        {
+            slot.last_use = m_use_counter;
+            return slot.mesh_id;
+        }
+    }
+
+    // Never used slots have last_use 0 and are taken first.
+    Slot& slot = *std::min_element(m_slots.begin(),
+                                   m_slots.end(),
+                                   [](const Slot& a, const Slot& b) { return a.last_use < b.last_use; });
+
+    slot.text.assign(text);
+    slot.last_use = m_use_counter;
+    slot.loaded = m_renderer.load(slot.mesh_id, m_font.create_text_mesh(slot.text));
+    ++m_builds_count;
+
+    return slot.mesh_id;
+}
+
+std::size_t TextCache::builds_count() const
+{
+    return m_builds_count;
+}
+
+std::size_t TextCache::slots_count() const
+{
+    return m_slots.size();
+}
@@ -0,0 +1,55 @@
+#ifndef LIFE_TEXT_CACHE_HPP
+#define LIFE_TEXT_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <graphics/font.hpp>
+#include <graphics/renderer.hpp>
+
+// Keeps text meshes loaded in the renderer, keyed on the text content.
+//
+// A mesh is only built and uploaded when the requested text is not in the cache, so text
+// that changes rarely (counters, labels) costs nothing between changes. When all slots are
+// taken the least recently used one is rebuilt.
+class TextCache
+{
+public:
+    using ResourceId = neutrino::graphics::Renderer::ResourceId;
+
+    static constexpr std::size_t DefaultSlotsCount = 4;
+
+    // Slots use resource ids in range [first_mesh_id, first_mesh_id + slots_count).
+    TextCache(neutrino::graphics::Renderer& renderer,
+              const neutrino::graphics::Font& font,
+              ResourceId first_mesh_id,
+              std::size_t slots_count = DefaultSlotsCount);
+
+    // Returns the mesh id of the text, building and loading the mesh only on a cache miss.
+    ResourceId get(std::string_view text);
+
+    // Number of meshes built since creation, to check the cache actually hits.
+    std::size_t builds_count() const;
+
+    std::size_t slots_count() const;
+
+private:
+    struct Slot
+    {
+        ResourceId mesh_id = 0;
+        std::string text;
+        std::uint64_t last_use = 0;
+        bool loaded = false;
+    };
+
+    neutrino::graphics::Renderer& m_renderer;
+    const neutrino::graphics::Font& m_font;
+    std::vector<Slot> m_slots;
+    std::uint64_t m_use_counter = 0;
+    std::size_t m_builds_count = 0;
+};
+
+#endif
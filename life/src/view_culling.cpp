@@ -0,0 +1,71 @@
+#include "view_culling.hpp"
+
+#include <algorithm>
+
+void ViewCulling::set_view(neutrino::Size size)
+{
+    m_view = size;
+    m_width = static_cast<float>(size.width);
+    m_height = static_cast<float>(size.height);
+
+    m_lod_columns = static_cast<std::size_t>(std::max(size.width / LodCellSize + 1, 1));
+    m_lod_rows = static_cast<std::size_t>(std::max(size.height / LodCellSize + 1, 1));
+    m_lod_cells.assign(m_lod_columns * m_lod_rows, 0);
+}
+
+neutrino::Size ViewCulling::view() const
+{
+    return m_view;
+}
+
+void ViewCulling::set_lod_enabled(bool enabled)
+{
+    m_lod_enabled = enabled;
+}
+
+bool ViewCulling::lod_enabled() const
+{
+    return m_lod_enabled;
+}
+
+void ViewCulling::begin_frame()
+{
+    if (m_lod_enabled)
+    {
+        std::fill(m_lod_cells.begin(), m_lod_cells.end(), std::uint8_t{0});
+    }
+
+    m_culled_count = 0;
+    m_merged_count = 0;
+}
+
+std::size_t ViewCulling::culled_count() const
+{
+    return m_culled_count;
+}
+
+std::size_t ViewCulling::merged_count() const
+{
+    return m_merged_count;
+}
+
+bool ViewCulling::claim_cell(float x, float y)
+{
+    // Quads crossing the view border with the center outside of it are always kept.
+    if (x < 0.0f || y < 0.0f || x > m_width || y > m_height)
+    {
+        return true;
+    }
+
+    const auto column = std::min(static_cast<std::size_t>(x) / LodCellSize, m_lod_columns - 1);
+    const auto row = std::min(static_cast<std::size_t>(y) / LodCellSize, m_lod_rows - 1);
+
+    std::uint8_t &cell = m_lod_cells[row * m_lod_columns + column];
+    if (cell != 0)
+    {
+        return false;
+    }
+
+    cell = 1;
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef LIFE_VIEW_CULLING_HPP
+#define LIFE_VIEW_CULLING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <common/size.hpp>
+#include <math/math.hpp>
+
+// Decides which entity quads are worth drawing in the current view.
+//
+// Quads with the box outside of the view are culled. With the density LOD enabled the view
+// is split into LodCellSize pixel cells and only the first quad centered in a cell is kept:
+// in a dense crowd the rest would land on the same pixels and be overdrawn anyway.
+class ViewCulling
+{
+public:
+    static constexpr int LodCellSize = 2;
+
+    // View covers [0, size.width] x [0, size.height] in world units, like the projection.
+    void set_view(neutrino::Size size);
+    neutrino::Size view() const;
+
+    void set_lod_enabled(bool enabled);
+    bool lod_enabled() const;
+
+    // Resets the LOD cells and the counters, call once before testing the quads of a frame.
+    void begin_frame();
+
+    bool visible(float left, float bottom, float right, float top)
+    {
+        if (right < 0.0f || left > m_width || top < 0.0f || bottom > m_height)
+        {
+            ++m_culled_count;
+            return false;
+        }
+
+        if (m_lod_enabled && !claim_cell((left + right) * 0.5f, (bottom + top) * 0.5f))
+        {
+            ++m_merged_count;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Quads rejected since begin_frame() for being out of view and for sharing a LOD cell.
+    std::size_t culled_count() const;
+    std::size_t merged_count() const;
+
+private:
+    bool claim_cell(float x, float y);
+
+    neutrino::Size m_view;
+    float m_width = 0.0f;
+    float m_height = 0.0f;
+
+    bool m_lod_enabled = false;
+    std::size_t m_lod_columns = 0;
+    std::size_t m_lod_rows = 0;
+    std::vector<std::uint8_t> m_lod_cells;
+
+    std::size_t m_culled_count = 0;
+    std::size_t m_merged_count = 0;
+};
+
+#endif
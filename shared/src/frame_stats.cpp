@@ -0,0 +1,141 @@
+#include "frame_stats.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    constexpr std::memory_order Relaxed = std::memory_order_relaxed;
+
+    std::uint32_t to_us(FrameStats::Clock::duration duration)
+    {
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        return static_cast<std::uint32_t>(std::clamp<std::chrono::microseconds::rep>(us, 0, UINT32_MAX));
+    }
+
+    double to_ms(double us)
+    {
+        return us / 1000.0;
+    }
+
+} // namespace
+
+FrameStats::FrameStats()
+    : m_frame_start(Clock::now()),
+      m_second_start(m_frame_start)
+{
+}
+
+void FrameStats::begin_frame()
+{
+    m_frame_start = Clock::now();
+}
+
+void FrameStats::begin_display()
+{
+    m_display_start = Clock::now();
+    m_display_started = true;
+}
+
+void FrameStats::end_frame()
+{
+    const auto now = Clock::now();
+    const auto display_time = m_display_started ? now - m_display_start : Clock::duration::zero();
+
+    record(now, now - m_frame_start, display_time);
+
+    m_frame_start = now;
+    m_display_started = false;
+}
+
+FrameStats::Clock::time_point FrameStats::frame_start() const
+{
+    return m_frame_start;
+}
+
+void FrameStats::record(Clock::duration frame_time)
+{
+    record(Clock::now(), frame_time, Clock::duration::zero());
+}
+
+void FrameStats::record(Clock::time_point now, Clock::duration frame_time, Clock::duration display_time)
+{
+    const std::uint32_t frame_us = to_us(frame_time);
+    const std::uint32_t display_us = to_us(display_time);
+
+    // Single writer: the slot being overwritten leaves the histogram and the sums before the
+    // new frame enters them. Readers may see a frame half way in, which only skews one sample.
+    if (m_count.load(Relaxed) == WindowFramesCount)
+    {
+        const std::uint32_t old_us = m_frames[m_next].load(Relaxed);
+        m_bins[bin_of(old_us)].fetch_sub(1, Relaxed);
+        m_sum_us.fetch_sub(old_us, Relaxed);
+        m_display_sum_us.fetch_sub(m_display[m_next].load(Relaxed), Relaxed);
+    }
+    else
+    {
+        m_count.fetch_add(1, Relaxed);
+    }
+
+    m_frames[m_next].store(frame_us, Relaxed);
+    m_display[m_next].store(display_us, Relaxed);
+    m_bins[bin_of(frame_us)].fetch_add(1, Relaxed);
+    m_sum_us.fetch_add(frame_us, Relaxed);
+    m_display_sum_us.fetch_add(display_us, Relaxed);
+    m_next = (m_next + 1) % WindowFramesCount;
+
+    ++m_second_frames;
+    if (now - m_second_start >= std::chrono::seconds(1))
+    {
+        m_fps.store(m_second_frames, Relaxed);
+        m_second_frames = 0;
+        m_second_start = now;
+    }
+}
+
+FrameStats::Summary FrameStats::summary() const
+{
+    Summary summary;
+    summary.fps = m_fps.load(Relaxed);
+    summary.frames_count = m_count.load(Relaxed);
+    if (summary.frames_count == 0)
+    {
+        return summary;
+    }
+
+    const auto count = static_cast<double>(summary.frames_count);
+    summary.mean_ms = to_ms(static_cast<double>(m_sum_us.load(Relaxed)) / count);
+    summary.display_ms = to_ms(static_cast<double>(m_display_sum_us.load(Relaxed)) / count);
+
+    std::uint32_t worst_us = 0;
+    for (const auto& frame : m_frames)
+    {
+        worst_us = std::max(worst_us, frame.load(Relaxed));
+    }
+    summary.worst_ms = to_ms(worst_us);
+
+    // Percentiles are the upper edges of the bins the ranks fall in.
+    const std::size_t total = summary.frames_count;
+    const std::array<std::pair<double*, std::size_t>, 3> ranks = {{{&summary.p50_ms, (total * 50 + 99) / 100},
+                                                                   {&summary.p95_ms, (total * 95 + 99) / 100},
+                                                                   {&summary.p99_ms, (total * 99 + 99) / 100}}};
+    std::size_t rank = 0;
+    std::size_t seen = 0;
+    for (std::size_t bin = 0; bin < BinsCount && rank < ranks.size(); ++bin)
+    {
+        seen += m_bins[bin].load(Relaxed);
+        while (rank < ranks.size() && seen >= ranks[rank].second)
+        {
+            const double edge_us = static_cast<double>((bin + 1) * BinWidth.count());
+            *ranks[rank].first = to_ms(std::min(edge_us, static_cast<double>(worst_us)));
+            ++rank;
+        }
+    }
+
+    return summary;
+}
+
+std::size_t FrameStats::bin_of(std::uint32_t frame_us)
+{
+    return std::min(static_cast<std::size_t>(frame_us / BinWidth.count()), BinsCount - 1);
+}
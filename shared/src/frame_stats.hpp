@@ -0,0 +1,81 @@
+#ifndef SHARED_FRAME_STATS_HPP
+#define SHARED_FRAME_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Frame time statistics shared by the examples.
+//
+// The frame thread records every frame time into a rolling window of the last WindowFramesCount
+// frames and into a histogram of the same frames, both made of atomics. Any thread can read a
+// summary at any time without locks: percentiles come from the histogram, so they are rounded
+// up to BinWidth, the worst frame is exact. Recording a frame takes a single clock read.
+class FrameStats
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t WindowFramesCount = 256;
+    static constexpr std::size_t BinsCount = 2000;
+    static constexpr std::chrono::microseconds BinWidth{50}; // last bin also counts all longer frames
+
+    struct Summary
+    {
+        std::uint32_t fps = 0; // frames ended during the last full second
+        std::size_t frames_count = 0;
+        double mean_ms = 0.0;
+        double p50_ms = 0.0;
+        double p95_ms = 0.0;
+        double p99_ms = 0.0;
+        double worst_ms = 0.0;
+
+        // Mean time blocked in display(), zero when the frames are not split. The rest of the
+        // mean frame time is CPU work of the frame.
+        double display_ms = 0.0;
+
+        bool operator==(const Summary&) const = default;
+    };
+
+    FrameStats();
+
+    // Frame thread side. A frame starts at begin_frame() or, without it, when the previous one
+    // ended. begin_display() optionally marks where the frame starts waiting in display().
+    void begin_frame();
+    void begin_display();
+    void end_frame();
+
+    // Start of the current frame, right after end_frame() it is the time the last frame ended.
+    Clock::time_point frame_start() const;
+
+    // Same as a frame of the given time that ended now, for frames timed by the caller.
+    void record(Clock::duration frame_time);
+
+    // Any thread.
+    Summary summary() const;
+
+private:
+    static std::size_t bin_of(std::uint32_t frame_us);
+    void record(Clock::time_point now, Clock::duration frame_time, Clock::duration display_time);
+
+    // Frame thread state.
+    Clock::time_point m_frame_start;
+    Clock::time_point m_display_start;
+    bool m_display_started = false;
+    Clock::time_point m_second_start;
+    std::uint32_t m_second_frames = 0;
+    std::size_t m_next = 0;
+
+    // Shared state, frame times in microseconds.
+    std::array<std::atomic<std::uint32_t>, WindowFramesCount> m_frames{};
+    std::array<std::atomic<std::uint32_t>, WindowFramesCount> m_display{};
+    std::array<std::atomic<std::uint32_t>, BinsCount> m_bins{};
+    std::atomic<std::size_t> m_count = 0;
+    std::atomic<std::uint64_t> m_sum_us = 0;
+    std::atomic<std::uint64_t> m_display_sum_us = 0;
+    std::atomic<std::uint32_t> m_fps = 0;
+};
+
+#endif
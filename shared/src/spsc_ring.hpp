@@ -0,0 +1,77 @@
+#ifndef SHARED_SPSC_RING_HPP
+#define SHARED_SPSC_RING_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Fixed-capacity single-producer/single-consumer queue.
+//
+// One thread pushes, one thread pops, neither takes a lock or allocates. Head and tail live
+// on separate cache lines so the two threads don't invalidate each other's writes.
+template <typename T, std::size_t Capacity>
+class SpscRing
+{
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "Items are copied around as plain data");
+
+    // Producer side. Returns false when the queue is full, the item is not added then.
+    bool try_push(const T& item)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cached_head == Capacity) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail - m_cached_head == Capacity) {
+                return false;
+            }
+        }
+
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool try_pop(T& item)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cached_tail) {
+                return false;
+            }
+        }
+
+        item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Exact only when called from one of the two threads while the other one is idle.
+    std::size_t size() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+
+    // Written by the consumer, the producer keeps its last seen value in m_cached_head.
+    alignas(CacheLineSize) std::atomic<std::size_t> m_head = 0;
+    std::size_t m_cached_tail = 0;
+
+    // Written by the producer.
+    alignas(CacheLineSize) std::atomic<std::size_t> m_tail = 0;
+    std::size_t m_cached_head = 0;
+
+    alignas(CacheLineSize) std::array<T, Capacity> m_items{};
+};
+
+#endif
@@ -0,0 +1,320 @@
+#include "tracer.hpp"
+
+#include <charconv>
+#include <stdexcept>
+#include <system_error>
+
+#include <log/log.hpp>
+
+namespace
+{
+    // Text is written out once it grows past this, so a flush after a burst stays bounded.
+    constexpr std::size_t MaxTextSize = 1024 * 1024;
+
+    std::int64_t to_ns(Tracer::Clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    void append_string(std::string& out, std::string_view text)
+    {
+        out += '"';
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+            }
+            out += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+        }
+        out += '"';
+    }
+
+    template <typename T>
+    void append_number(std::string& out, T value)
+    {
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    // Trace times are microseconds, kept to nanoseconds.
+    void append_us(std::string& out, std::int64_t ns)
+    {
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<double>(ns) / 1000.0,
+                                          std::chars_format::fixed, 3);
+        out.append(buffer, result.ptr);
+    }
+
+} // namespace
+
+Tracer::Scope::Scope(const char* name)
+    : m_name(Tracer::instance().running() ? name : nullptr)
+{
+    if (m_name != nullptr)
+    {
+        m_start = Clock::now();
+    }
+}
+
+Tracer::Scope::~Scope()
+{
+    if (m_name != nullptr)
+    {
+        Tracer::instance().record(m_name, m_start, Clock::now());
+    }
+}
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::~Tracer()
+{
+    stop();
+}
+
+void Tracer::start(const std::filesystem::path& path, std::uint64_t max_file_size)
+{
+    stop();
+
+    m_path = path;
+    m_max_file_size = max_file_size;
+    open_file();
+
+    // Events of scopes that closed after the last stop belong to no trace.
+    {
+        std::lock_guard lock(m_mutex);
+        Event event;
+        for (const auto& buffer : m_buffers)
+        {
+            while (buffer->events.try_pop(event))
+            {
+            }
+        }
+    }
+
+    m_epoch_ns = to_ns(Clock::now());
+    m_dropped_events.store(0, std::memory_order_relaxed);
+    m_stop_writer = false;
+    m_running.store(true, std::memory_order_relaxed);
+    m_writer = std::thread(&Tracer::run, this);
+}
+
+void Tracer::stop()
+{
+    if (!m_running.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    m_running.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(m_writer_mutex);
+        m_stop_writer = true;
+    }
+    m_writer_wake.notify_one();
+    m_writer.join();
+
+    flush();
+    close_file();
+}
+
+bool Tracer::running() const
+{
+    return m_running.load(std::memory_order_relaxed);
+}
+
+void Tracer::set_thread_name(std::string_view name)
+{
+    ThreadBuffer& buffer = thread_buffer();
+
+    std::lock_guard lock(m_mutex);
+    buffer.name = name;
+    buffer.name_written = false;
+}
+
+const char* Tracer::intern(std::string_view name)
+{
+    std::lock_guard lock(m_mutex);
+    return m_interned.emplace(name).first->c_str();
+}
+
+std::uint64_t Tracer::dropped_events() const
+{
+    return m_dropped_events.load(std::memory_order_relaxed);
+}
+
+Tracer::ThreadBuffer& Tracer::thread_buffer()
+{
+    // Buffers are never freed, the writer may still drain one after its thread exited.
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr)
+    {
+        std::lock_guard lock(m_mutex);
+        m_buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = m_buffers.back().get();
+        buffer->id = static_cast<std::uint32_t>(m_buffers.size());
+    }
+    return *buffer;
+}
+
+void Tracer::record(const char* name, Clock::time_point start, Clock::time_point end)
+{
+    if (!m_running.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    if (!thread_buffer().events.try_push(Event{.name = name, .start_ns = to_ns(start), .end_ns = to_ns(end)}))
+    {
+        m_dropped_events.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Tracer::run()
+{
+    std::unique_lock lock(m_writer_mutex);
+    while (!m_stop_writer)
+    {
+        m_writer_wake.wait_for(lock, FlushInterval, [this]() { return m_stop_writer; });
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void Tracer::flush()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_flush_buffers.clear();
+        for (const auto& buffer : m_buffers)
+        {
+            m_flush_buffers.push_back(buffer.get());
+
+            if (!buffer->name_written)
+            {
+                append_thread_name(m_text, *buffer);
+            }
+        }
+    }
+
+    Event event;
+    for (ThreadBuffer* buffer : m_flush_buffers)
+    {
+        while (buffer->events.try_pop(event))
+        {
+            m_text += m_first_event ? "\n" : ",\n";
+            m_text += R"({"name":)";
+            append_string(m_text, event.name);
+            m_text += R"(,"ph":"X","pid":1,"tid":)";
+            append_number(m_text, buffer->id);
+            m_text += R"(,"ts":)";
+            append_us(m_text, event.start_ns - m_epoch_ns);
+            m_text += R"(,"dur":)";
+            append_us(m_text, event.end_ns - event.start_ns);
+            m_text += '}';
+            m_first_event = false;
+
+            if (m_text.size() > MaxTextSize)
+            {
+                write_text();
+            }
+        }
+    }
+
+    write_text();
+}
+
+void Tracer::open_file()
+{
+    m_file.open(m_path, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+    {
+        throw std::runtime_error("Can't create " + m_path.string());
+    }
+
+    m_first_event = true;
+
+    // Every file is a complete trace, thread names go into each one.
+    std::string header = "[";
+    {
+        std::lock_guard lock(m_mutex);
+        for (const auto& buffer : m_buffers)
+        {
+            buffer->name_written = false;
+            append_thread_name(header, *buffer);
+        }
+    }
+
+    m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    m_file_size = header.size();
+}
+
+void Tracer::append_thread_name(std::string& out, ThreadBuffer& buffer)
+{
+    if (buffer.name.empty())
+    {
+        return;
+    }
+
+    out += m_first_event ? "\n" : ",\n";
+    out += R"({"name":"thread_name","ph":"M","pid":1,"tid":)";
+    append_number(out, buffer.id);
+    out += R"(,"args":{"name":)";
+    append_string(out, buffer.name);
+    out += "}}";
+    m_first_event = false;
+    buffer.name_written = true;
+}
+
+void Tracer::close_file()
+{
+    if (m_file.is_open())
+    {
+        m_file << "\n]\n";
+        m_file.close();
+    }
+}
+
+void Tracer::write_text()
+{
+    if (m_file.is_open())
+    {
+        m_file.write(m_text.data(), static_cast<std::streamsize>(m_text.size()));
+        m_file_size += m_text.size();
+
+        if (!m_file)
+        {
+            neutrino::log::error("Tracer") << "Can't write " << m_path.string() << ", trace output stopped";
+            m_file.close();
+        }
+    }
+    m_text.clear();
+
+    if (m_file.is_open() && m_file_size > m_max_file_size)
+    {
+        close_file();
+
+        std::filesystem::path previous = m_path;
+        previous += ".1";
+
+        std::error_code error;
+        std::filesystem::remove(previous, error);
+        std::filesystem::rename(m_path, previous, error);
+
+        try
+        {
+            open_file();
+        }
+        catch (const std::runtime_error& e)
+        {
+            neutrino::log::error("Tracer") << e.what();
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef SHARED_TRACER_HPP
+#define SHARED_TRACER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "spsc_ring.hpp"
+
+// Continuous scope tracing into Chrome trace files, readable by chrome://tracing and Perfetto.
+//
+// A scope is pushed into a lock-free ring owned by the thread that closes it, a background thread
+// drains all rings every FlushInterval and appends the events to the trace file. Once the file
+// grows past its size limit it is moved to <path>.1, replacing the previous one, and a new file is
+// started. A long session keeps its latest data on disk while memory use stays fixed. Events that
+// do not fit into a full ring are dropped and counted. While no trace runs a scope costs one
+// relaxed atomic load.
+class Tracer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t ThreadEventsCount = 8192;
+    static constexpr std::uint64_t DefaultMaxFileSize = 64 * 1024 * 1024;
+    static constexpr std::chrono::milliseconds FlushInterval{100};
+
+    // Traces the enclosing block if a trace is running when it is opened.
+    class Scope
+    {
+    public:
+        // The name must stay valid until the trace is stopped: a literal or an interned name.
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        Clock::time_point m_start;
+    };
+
+    static Tracer& instance();
+
+    ~Tracer();
+
+    // Starts writing a new trace, a running one is stopped first. Start and stop are called from
+    // one thread at a time. Throws std::runtime_error when the file can't be created.
+    void start(const std::filesystem::path& path, std::uint64_t max_file_size = DefaultMaxFileSize);
+
+    // Writes all buffered events and closes the file.
+    void stop();
+
+    bool running() const;
+
+    // Names the calling thread in traces.
+    void set_thread_name(std::string_view name);
+
+    // Copy of the name that stays valid until exit, for scope names built at runtime.
+    const char* intern(std::string_view name);
+
+    // Events dropped on full thread rings since the trace started.
+    std::uint64_t dropped_events() const;
+
+private:
+    struct Event
+    {
+        const char* name = nullptr;
+        std::int64_t start_ns = 0;
+        std::int64_t end_ns = 0;
+    };
+
+    struct ThreadBuffer
+    {
+        SpscRing<Event, ThreadEventsCount> events;
+        std::uint32_t id = 0;
+
+        // Guarded by m_mutex.
+        std::string name;
+        bool name_written = false;
+    };
+
+    Tracer() = default;
+
+    ThreadBuffer& thread_buffer();
+    void record(const char* name, Clock::time_point start, Clock::time_point end);
+
+    // Writer side, run by the writer thread, or by start() and stop() while it is not running.
+    void run();
+    void flush();
+    void open_file();
+    void close_file();
+    void write_text();
+
+    // Called with m_mutex locked, does nothing for unnamed threads.
+    void append_thread_name(std::string& out, ThreadBuffer& buffer);
+
+    std::atomic<bool> m_running = false;
+    std::atomic<std::uint64_t> m_dropped_events = 0;
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    std::unordered_set<std::string> m_interned;
+
+    std::filesystem::path m_path;
+    std::uint64_t m_max_file_size = DefaultMaxFileSize;
+    std::ofstream m_file;
+    std::uint64_t m_file_size = 0;
+    bool m_first_event = true;
+    std::string m_text;
+    std::vector<ThreadBuffer*> m_flush_buffers;
+    std::int64_t m_epoch_ns = 0;
+
+    std::thread m_writer;
+    std::mutex m_writer_mutex;
+    std::condition_variable m_writer_wake;
+    bool m_stop_writer = false;
+};
+
+#endif
@@ -1,66 +1,94 @@
 ﻿#include "data_context.hpp"
 
+#include <algorithm>
+
 using namespace neutrino;
 using namespace system;
 
 void DataContext::set_window_state(Window::State state)
 {
-    m_window_state = state;
+    update(m_window_state, state);
 }
 
 void DataContext::set_window_size(Size size)
 {
-    m_window_size = size;
+    update(m_window_size, size);
 }
 
 void DataContext::set_windos_position(Position position)
 {
-    m_window_position = position;
+    update(m_window_position, position);
 }
 
 void DataContext::set_window_cursor_position(Position position)
 {
-    m_window_cursor_position = position;
+    update(m_window_cursor_position, position);
 }
 
 void DataContext::set_window_resizable(bool value)
 {
-    m_window_resizable = value;
+    update(m_window_resizable, value);
 }
 
 void DataContext::set_window_has_input_focus(bool value)
 {
-    m_window_has_input_focus = value;
+    update(m_window_has_input_focus, value);
 }
 
 void DataContext::set_cursor_captured(bool value)
 {
-    m_cursor_captured = value;
+    update(m_cursor_captured, value);
 }
 
 void DataContext::set_cursor_visible(bool value)
 {
-    m_cursor_visible = value;
+    update(m_cursor_visible, value);
 }
 
 void DataContext::set_cursor_hover(bool value)
 {
-    m_cursor_hover = value;
+    update(m_cursor_hover, value);
+}
+
+void DataContext::set_frame_stats(const FrameStats::Summary& stats)
+{
+    m_frame_stats = stats;
+}
+
+void DataContext::set_events_coalescing(bool value)
+{
+    update(m_events_coalescing, value);
+}
+
+void DataContext::set_coalesced_events(std::uint64_t count)
+{
+    update(m_coalesced_events, count);
 }
 
-void DataContext::set_fps(std::uint32_t fps)
+void DataContext::set_frame_pacing(FramePacing pacing)
 {
-    m_fps = fps;
+    update(m_frame_pacing, pacing);
 }
 
-void DataContext::add_callback_event(const std::string& event)
+void DataContext::set_input_latency(std::int64_t mean, std::int64_t p99)
 {
-    static constexpr size_t max_events = 100;
+    m_input_latency_mean = mean;
+    m_input_latency_p99  = p99;
+}
 
-    m_callbacks_events.insert(m_callbacks_events.begin(), event);
-    if (m_callbacks_events.size() > max_events) {
-        m_callbacks_events.pop_back();
-    }
+void DataContext::add_callback_event(const EventRecord& event)
+{
+    // The log is a ring, the newest event overwrites the oldest one.
+    m_callbacks_events_newest                     = (m_callbacks_events_newest + 1) % MaxCallbackEvents;
+    m_callbacks_events[m_callbacks_events_newest] = event;
+    m_callbacks_events_count                      = std::min(m_callbacks_events_count + 1, MaxCallbackEvents);
+    ++m_callbacks_events_received;
+    m_dirty = true;
+}
+
+void DataContext::set_dropped_callback_events(std::uint64_t count)
+{
+    update(m_dropped_callbacks_events, count);
 }
 
 Window::State DataContext::window_state() const
@@ -108,12 +136,62 @@ bool DataContext::cursor_hover() const
     return m_cursor_hover;
 }
 
-std::uint32_t DataContext::fps() const
+const FrameStats::Summary& DataContext::frame_stats() const
+{
+    return m_frame_stats;
+}
+
+bool DataContext::events_coalescing() const
+{
+    return m_events_coalescing;
+}
+
+std::uint64_t DataContext::coalesced_events() const
+{
+    return m_coalesced_events;
+}
+
+std::int64_t DataContext::input_latency_mean() const
+{
+    return m_input_latency_mean;
+}
+
+std::int64_t DataContext::input_latency_p99() const
+{
+    return m_input_latency_p99;
+}
+
+FramePacing DataContext::frame_pacing() const
+{
+    return m_frame_pacing;
+}
+
+bool DataContext::is_dirty() const
+{
+    return m_dirty;
+}
+
+void DataContext::clear_dirty()
+{
+    m_dirty = false;
+}
+
+std::size_t DataContext::callback_events_count() const
+{
+    return m_callbacks_events_count;
+}
+
+std::uint64_t DataContext::callback_events_received() const
+{
+    return m_callbacks_events_received;
+}
+
+const EventRecord& DataContext::callback_event(std::size_t index) const
 {
-    return m_fps;
+    return m_callbacks_events[(m_callbacks_events_newest + MaxCallbackEvents - index) % MaxCallbackEvents];
 }
 
-const std::vector<std::string>& DataContext::last_callback_events() const
+std::uint64_t DataContext::dropped_callback_events() const
 {
-    return m_callbacks_events;
+    return m_dropped_callbacks_events;
 }
@@ -1,19 +1,28 @@
 #ifndef WINDOW_EVENTS_DATA_CONTEXT_HPP
 #define WINDOW_EVENTS_DATA_CONTEXT_HPP
 
-#include <string>
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
 #include <common/position.hpp>
 #include <common/size.hpp>
 #include <system/window.hpp>
 
+#include "event_record.hpp"
+#include "frame_stats.hpp"
+#include "frame_pacer.hpp"
+
 using neutrino::Position;
 using neutrino::Size;
 
+// Everything View displays, as plain data. It is copied as a whole into the snapshots the render
+// thread draws from.
 class DataContext
 {
 public:
+    static constexpr std::size_t MaxCallbackEvents = 100;
+
     void set_window_state(neutrino::system::Window::State state);
     void set_window_size(Size size);
     void set_windos_position(Position position);
@@ -25,9 +34,22 @@ public:
     void set_cursor_visible(bool value);
     void set_cursor_hover(bool value);
 
-    void set_fps(std::uint32_t fps);
+    // Render stats change with every rendered frame, so they do not mark the context dirty: a
+    // redraw for them would redraw again for its own stats and on-change pacing would never idle.
+    void set_frame_stats(const FrameStats::Summary& stats);
+
+    void set_events_coalescing(bool value);
+    void set_coalesced_events(std::uint64_t count);
+
+    void set_frame_pacing(FramePacing pacing);
+
+    // Input-to-display latency measured by the render thread, in nanoseconds. Does not mark
+    // the context dirty either.
+    void set_input_latency(std::int64_t mean, std::int64_t p99);
 
-    void add_callback_event(const std::string& event);
+    // Adds the event to the log of the last MaxCallbackEvents.
+    void add_callback_event(const EventRecord& event);
+    void set_dropped_callback_events(std::uint64_t count);
 
     neutrino::system::Window::State window_state() const;
     Size window_size() const;
@@ -40,13 +62,53 @@ public:
     bool cursor_visible() const;
     bool cursor_hover() const;
 
-    std::uint32_t fps() const;
+    const FrameStats::Summary& frame_stats() const;
+
+    bool events_coalescing() const;
+    std::uint64_t coalesced_events() const;
+
+    FramePacing frame_pacing() const;
+
+    // Set when anything displayed changes: a setter gets a new value or an event reaches the log.
+    // Cleared once the data is published to the render thread.
+    bool is_dirty() const;
+    void clear_dirty();
+
+    // Zero until the first displayed event.
+    std::int64_t input_latency_mean() const;
+    std::int64_t input_latency_p99() const;
 
-    const std::vector<std::string>& last_callback_events() const;
+    // Log of the last events, index 0 is the newest one.
+    std::size_t callback_events_count() const;
+
+    // Number of events added to the log so far, the newest one has number received - 1.
+    std::uint64_t callback_events_received() const;
+    const EventRecord& callback_event(std::size_t index) const;
+
+    std::uint64_t dropped_callback_events() const;
 
 private:
+    template <typename T>
+    void update(T& field, const T& value)
+    {
+        if (!(field == value)) {
+            field   = value;
+            m_dirty = true;
+        }
+    }
+
+    bool m_dirty = true;
+
     neutrino::system::Window::State m_window_state = neutrino::system::Window::State::normal;
-    std::vector<std::string> m_callbacks_events;
+    std::array<EventRecord, MaxCallbackEvents> m_callbacks_events;
+    std::size_t m_callbacks_events_newest = 0;
+    std::size_t m_callbacks_events_count  = 0;
+    std::uint64_t m_callbacks_events_received = 0;
+    std::uint64_t m_dropped_callbacks_events  = 0;
+
+    std::int64_t m_input_latency_mean = 0;
+    std::int64_t m_input_latency_p99  = 0;
+
     Size m_window_size;
     Position m_window_position;
     Position m_window_cursor_position;
@@ -57,7 +119,12 @@ private:
     bool m_cursor_visible  = false;
     bool m_cursor_hover    = false;
 
-    std::uint32_t m_fps = 0;
+    FrameStats::Summary m_frame_stats;
+
+    bool m_events_coalescing         = false;
+    std::uint64_t m_coalesced_events = 0;
+
+    FramePacing m_frame_pacing = FramePacing::on_change;
 };
 
 #endif
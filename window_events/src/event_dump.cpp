@@ -0,0 +1,25 @@
+#include "event_dump.hpp"
+
+#include <stdexcept>
+
+EventDump::EventDump(const std::filesystem::path& path)
+    : m_file(path, std::ios::binary | std::ios::trunc)
+{
+    if (!m_file) {
+        throw std::runtime_error("Can't create " + path.string());
+    }
+
+    const EventDumpHeader header;
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void EventDump::write(const EventRecord& record)
+{
+    m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    ++m_records_count;
+}
+
+std::uint64_t EventDump::records_count() const
+{
+    return m_records_count;
+}
@@ -0,0 +1,40 @@
+#ifndef WINDOW_EVENTS_EVENT_DUMP_HPP
+#define WINDOW_EVENTS_EVENT_DUMP_HPP
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+#include "event_record.hpp"
+
+// Writes raw event records to a binary file for offline latency analysis.
+//
+// The file starts with an EventDumpHeader, followed by the EventRecord structs exactly as
+// they are in memory, in the order the events were received.
+struct EventDumpHeader
+{
+    static constexpr std::array<char, 8> Magic    = {'W', 'E', 'V', 'E', 'N', 'T', 'S', '\0'};
+    static constexpr std::uint32_t CurrentVersion = 1;
+
+    std::array<char, 8> magic = Magic;
+    std::uint32_t version     = CurrentVersion;
+    std::uint32_t record_size = sizeof(EventRecord);
+};
+
+class EventDump
+{
+public:
+    // Throws std::runtime_error when the file can't be created.
+    explicit EventDump(const std::filesystem::path& path);
+
+    void write(const EventRecord& record);
+
+    std::uint64_t records_count() const;
+
+private:
+    std::ofstream m_file;
+    std::uint64_t m_records_count = 0;
+};
+
+#endif
@@ -1,8 +1,13 @@
 #include "event_handler.hpp"
 
-#include <sstream>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+#include <log/log.hpp>
 
 #include "data_context.hpp"
+#include "tracer.hpp"
 
 using namespace neutrino;
 using namespace neutrino::system;
@@ -10,214 +15,8 @@ using namespace neutrino::system;
 namespace
 {
 
-std::string key_name(KeyCode key)
-{
-    switch (key) {
-        case KeyCode::unknown: return "unknown";
-
-        // Printable
-        case KeyCode::key_space: return "key_space";
-        case KeyCode::key_apostrophe: return "key_apostrophe";
-        case KeyCode::key_comma: return "key_comma";
-        case KeyCode::key_minus: return "key_minus";
-        case KeyCode::key_period: return "key_period";
-        case KeyCode::key_slash: return "key_slash";
-        case KeyCode::key_0: return "key_0";
-        case KeyCode::key_1: return "key_1";
-        case KeyCode::key_2: return "key_2";
-        case KeyCode::key_3: return "key_3";
-        case KeyCode::key_4: return "key_4";
-        case KeyCode::key_5: return "key_5";
-        case KeyCode::key_6: return "key_6";
-        case KeyCode::key_7: return "key_7";
-        case KeyCode::key_8: return "key_8";
-        case KeyCode::key_9: return "key_9";
-        case KeyCode::key_semicolon: return "key_semicolon";
-        case KeyCode::key_equal: return "key_equal";
-        case KeyCode::key_a: return "key_a";
-        case KeyCode::key_b: return "key_b";
-        case KeyCode::key_c: return "key_c";
-        case KeyCode::key_d: return "key_d";
-        case KeyCode::key_e: return "key_e";
-        case KeyCode::key_f: return "key_f";
-        case KeyCode::key_g: return "key_g";
-        case KeyCode::key_h: return "key_h";
-        case KeyCode::key_i: return "key_i";
-        case KeyCode::key_j: return "key_j";
-        case KeyCode::key_k: return "key_k";
-        case KeyCode::key_l: return "key_l";
-        case KeyCode::key_m: return "key_m";
-        case KeyCode::key_n: return "key_n";
-        case KeyCode::key_o: return "key_o";
-        case KeyCode::key_p: return "key_p";
-        case KeyCode::key_q: return "key_q";
-        case KeyCode::key_r: return "key_r";
-        case KeyCode::key_s: return "key_s";
-        case KeyCode::key_t: return "key_t";
-        case KeyCode::key_u: return "key_u";
-        case KeyCode::key_v: return "key_v";
-        case KeyCode::key_w: return "key_w";
-        case KeyCode::key_x: return "key_x";
-        case KeyCode::key_y: return "key_y";
-        case KeyCode::key_z: return "key_z";
-        case KeyCode::key_left_bracket: return "key_left_bracket";
-        case KeyCode::key_backslash: return "key_backslash";
-        case KeyCode::key_right_bracket: return "key_right_bracket";
-        case KeyCode::key_grave_accent: return "key_grave_accent";
-        case KeyCode::key_section: return "key_section";
-
-        // navigation
-        case KeyCode::key_escape: return "key_escape";
-        case KeyCode::key_enter: return "key_enter";
-        case KeyCode::key_tab: return "key_tab";
-        case KeyCode::key_backspace: return "key_backspace";
-        case KeyCode::key_insert: return "key_insert";
-        case KeyCode::key_delete: return "key_delete";
-        case KeyCode::key_right: return "key_right";
-        case KeyCode::key_left: return "key_left";
-        case KeyCode::key_down: return "key_down";
-        case KeyCode::key_up: return "key_up";
-        case KeyCode::key_page_up: return "key_page_up";
-        case KeyCode::key_page_down: return "key_page_down";
-        case KeyCode::key_home: return "key_home";
-        case KeyCode::key_end: return "key_end";
-        case KeyCode::key_caps_lock: return "key_caps_lock";
-        case KeyCode::key_scroll_lock: return "key_scroll_lock";
-        case KeyCode::key_num_lock: return "key_num_lock";
-        case KeyCode::key_print_screen: return "key_print_screen";
-        case KeyCode::key_pause: return "key_pause";
-
-        // Function keys
-        case KeyCode::key_f1: return "key_f1";
-        case KeyCode::key_f2: return "key_f2";
-        case KeyCode::key_f3: return "key_f3";
-        case KeyCode::key_f4: return "key_f4";
-        case KeyCode::key_f5: return "key_f5";
-        case KeyCode::key_f6: return "key_f6";
-        case KeyCode::key_f7: return "key_f7";
-        case KeyCode::key_f8: return "key_f8";
-        case KeyCode::key_f9: return "key_f9";
-        case KeyCode::key_f10: return "key_f10";
-        case KeyCode::key_f11: return "key_f11";
-        case KeyCode::key_f12: return "key_f12";
-        case KeyCode::key_f13: return "key_f13";
-        case KeyCode::key_f14: return "key_f14";
-        case KeyCode::key_f15: return "key_f15";
-        case KeyCode::key_f16: return "key_f16";
-        case KeyCode::key_f17: return "key_f17";
-        case KeyCode::key_f18: return "key_f18";
-        case KeyCode::key_f19: return "key_f19";
-        case KeyCode::key_f20: return "key_f20";
-        case KeyCode::key_f21: return "key_f21";
-        case KeyCode::key_f22: return "key_f22";
-        case KeyCode::key_f23: return "key_f23";
-        case KeyCode::key_f24: return "key_f24";
-
-        // numpad
-        case KeyCode::key_num_0: return "key_num_0";
-        case KeyCode::key_num_1: return "key_num_1";
-        case KeyCode::key_num_2: return "key_num_2";
-        case KeyCode::key_num_3: return "key_num_3";
-        case KeyCode::key_num_4: return "key_num_4";
-        case KeyCode::key_num_5: return "key_num_5";
-        case KeyCode::key_num_6: return "key_num_6";
-        case KeyCode::key_num_7: return "key_num_7";
-        case KeyCode::key_num_8: return "key_num_8";
-        case KeyCode::key_num_9: return "key_num_9";
-        case KeyCode::key_num_decimal: return "key_num_decimal";
-        case KeyCode::key_num_divide: return "key_num_divide";
-        case KeyCode::key_num_multiply: return "key_num_multiply";
-        case KeyCode::key_num_subtract: return "key_num_subtract";
-        case KeyCode::key_num_add: return "key_num_add";
-        case KeyCode::key_num_separator: return "key_num_separator";
-
-        // modifiers
-        case KeyCode::key_left_shift: return "key_left_shift";
-        case KeyCode::key_left_control: return "key_left_control";
-        case KeyCode::key_left_alt: return "key_left_alt";
-        case KeyCode::key_left_super: return "key_left_super";
-
-        case KeyCode::key_right_shift: return "key_right_shift";
-        case KeyCode::key_right_control: return "key_right_control";
-        case KeyCode::key_right_alt: return "key_right_alt";
-        case KeyCode::key_right_super: return "key_right_super";
-
-        case KeyCode::key_function: return "key_function";
-    }
-
-    return "undefined";
-}
-
-std::string button_name(MouseButton button)
-{
-    switch (button) {
-        case MouseButton::button_left: return "Left";
-        case MouseButton::button_right: return "Right";
-        case MouseButton::button_middle: return "Middle";
-        case MouseButton::button_4: return "Button_4";
-        case MouseButton::button_5: return "Button_5";
-        case MouseButton::button_6: return "Button_6";
-
-        case MouseButton::unknown: return "Unknown";
-    }
-
-    return "undefined";
-}
-
-std::string to_string(const Modifiers state)
-{
-    std::string s;
-
-    if (state & Modifiers::shift) {
-        s += "S";
-    }
-
-    if (state & Modifiers::control) {
-        s += "C";
-    }
-
-    if (state & Modifiers::alt) {
-        s += "M";
-    }
-
-    if (state & Modifiers::super) {
-        s += "W";
-    }
-
-    if (state & Modifiers::caps_lock) {
-        s += "L";
-    }
-
-    if (state & Modifiers::num_lock) {
-        s += "N";
-    }
-
-    if (state & Modifiers::function) {
-        s += "F";
-    }
-
-    return s;
-}
-
-std::string to_string(const Position& p)
-{
-    std::stringstream ss;
-    ss << p;
-    return ss.str();
-}
-
-std::string to_string(const Size& s)
-{
-    std::stringstream ss;
-    ss << s;
-    return ss.str();
-}
-
-std::string to_string(const KeyCode& k)
-{
-    std::stringstream ss;
-    return std::to_string(static_cast<int>(k));
-}
+const std::filesystem::path EventDumpPath = "events.bin";
+const std::filesystem::path TracePath     = "window_events.trace.json";
 
 } // namespace
 
@@ -225,7 +24,7 @@ EventHandler::EventHandler(Window& w)
     : m_window(w)
 {
     m_data_context.set_window_state(m_window.state());
-    m_last_frame_time = Clock::now();
+    m_data_context.set_window_size(m_window.size());
 }
 
 const DataContext& EventHandler::data_context() const
@@ -235,52 +34,54 @@ const DataContext& EventHandler::data_context() const
 
 void EventHandler::on_show()
 {
-    m_data_context.add_callback_event("on_show");
+    add_event({.type = EventType::show, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_hide()
 {
-    m_data_context.add_callback_event("on_hide");
+    add_event({.type = EventType::hide, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_close()
 {
-    m_data_context.add_callback_event("on_close");
+    add_event({.type = EventType::close, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_focus()
 {
-    m_data_context.add_callback_event("on_focus");
+    add_event({.type = EventType::focus, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_lost_focus()
 {
-    m_data_context.add_callback_event("on_focus_lost");
+    add_event({.type = EventType::focus_lost, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_resize(Size size)
 {
-    m_data_context.add_callback_event("on_size: " + to_string(size));
-    m_data_context.set_window_size(size);
+    add_event(
+    {.type = EventType::resize, .x = size.width, .y = size.height, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_move(Position p)
 {
-    m_data_context.add_callback_event("on_position: " + to_string(p));
-    m_data_context.set_windos_position(p);
+    add_event({.type = EventType::move, .x = p.x, .y = p.y, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_key_down(KeyCode key, Modifiers state)
 {
-    m_data_context.add_callback_event("on_key_down key: " + to_string(key) + " " + key_name(key) + " " +
-                                      to_string(state));
+    add_event(
+    {.type = EventType::key_down, .key = key, .modifiers = state, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_key_up(KeyCode key, Modifiers state)
 {
-    m_data_context.add_callback_event("on_key_up key: " + to_string(key) + " " + key_name(key) + " " +
-                                      to_string(state));
+    add_event(
+    {.type = EventType::key_up, .key = key, .modifiers = state, .timestamp = event_timestamp()});
+}
 
+void EventHandler::run_key_action(KeyCode key)
+{
     switch (key) {
         case KeyCode::key_q: close_window(); break;
         case KeyCode::key_f: toggle_fullscreen(); break;
@@ -290,50 +91,79 @@ void EventHandler::on_key_up(KeyCode key, Modifiers state)
         case KeyCode::key_r: toggle_resizable(); break;
         case KeyCode::key_g: toggle_cursor_capture(); break;
         case KeyCode::key_v: toggle_cursor_visible(); break;
+        case KeyCode::key_d: toggle_event_dump(); break;
+        case KeyCode::key_c: toggle_events_coalescing(); break;
+        case KeyCode::key_p: next_frame_pacing(); break;
+        case KeyCode::key_t: toggle_trace(); break;
         default: break;
     }
 }
 
 void EventHandler::on_mouse_enter()
 {
-    m_data_context.add_callback_event("on_mouse_enter");
+    add_event({.type = EventType::mouse_enter, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_mouse_leave()
 {
-    m_data_context.add_callback_event("on_mouse_leave");
+    add_event({.type = EventType::mouse_leave, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_mouse_move(CursorPosition p)
 {
-    m_data_context.add_callback_event("on_mouse_move " + to_string(p));
-    m_data_context.set_window_cursor_position(p);
+    add_coalescable_event({.type = EventType::mouse_move, .x = p.x, .y = p.y, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_mouse_button_down(MouseButton button, CursorPosition position, Modifiers state)
 {
-    m_data_context.add_callback_event("on_mouse_down: " + button_name(button) + " " + to_string(position) + " " +
-                                      to_string(state));
+    add_event({.type      = EventType::mouse_button_down,
+               .button    = button,
+               .modifiers = state,
+               .x         = position.x,
+               .y         = position.y,
+               .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_mouse_button_up(MouseButton button, CursorPosition position, Modifiers state)
 {
-    m_data_context.add_callback_event("on_mouse_up: " + button_name(button) + " " + to_string(position) + " " +
-                                      to_string(state));
+    add_event({.type      = EventType::mouse_button_up,
+               .button    = button,
+               .modifiers = state,
+               .x         = position.x,
+               .y         = position.y,
+               .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_mouse_scroll(ScrollOffset offset)
 {
-    m_data_context.add_callback_event("on_mouse_scroll: " + to_string(offset));
+    add_coalescable_event(
+    {.type = EventType::mouse_scroll, .x = offset.x, .y = offset.y, .timestamp = event_timestamp()});
 }
 
 void EventHandler::on_character(const std::string& s)
 {
-    m_data_context.add_callback_event("on_character: " + s);
+    EventRecord record{.type = EventType::character, .timestamp = event_timestamp()};
+    record.text_size = static_cast<std::uint8_t>(std::min(s.size(), record.text.size()));
+    std::copy_n(s.begin(), record.text_size, record.text.begin());
+
+    add_event(record);
+}
+
+void EventHandler::flush_events()
+{
+    flush_coalesced_event();
 }
 
 void EventHandler::on_update()
 {
+    Tracer::Scope trace("EventHandler::on_update");
+
+    EventRecord event;
+    while (m_events_queue.try_pop(event)) {
+        apply_event(event);
+    }
+    m_data_context.set_dropped_callback_events(m_dropped_events.load(std::memory_order_relaxed));
+
     m_data_context.set_window_state(m_window.state());
     m_data_context.set_window_resizable(m_window.is_resizable());
     m_data_context.set_window_has_input_focus(m_window.has_input_focus());
@@ -341,17 +171,90 @@ void EventHandler::on_update()
     m_data_context.set_cursor_captured(m_window.is_cursor_captured());
     m_data_context.set_cursor_visible(m_window.is_cursor_visible());
     m_data_context.set_cursor_hover(m_window.is_cursor_hover());
-    
-    m_current_fps++;
-    m_frame_counter_duration += (Clock::now() - m_last_frame_time);
-    while (m_frame_counter_duration > std::chrono::seconds(1)) {
-        m_frame_counter_duration -= std::chrono::seconds(1);
-        m_fps = m_current_fps;
-        m_current_fps = 0;
+
+    m_data_context.set_events_coalescing(m_coalesce_events.load(std::memory_order_relaxed));
+    m_data_context.set_coalesced_events(m_coalesced_events_count.load(std::memory_order_relaxed));
+    m_data_context.set_frame_pacing(m_frame_pacing);
+}
+
+void EventHandler::set_render_stats(const RenderStats& stats)
+{
+    m_data_context.set_frame_stats(stats.frame);
+    m_data_context.set_input_latency(stats.input_latency_mean, stats.input_latency_p99);
+}
+
+void EventHandler::publish(TripleBuffer<DataContext>& snapshots)
+{
+    const auto now           = std::chrono::steady_clock::now();
+    const bool stats_refresh = m_frame_pacing != FramePacing::on_change && now - m_last_publish >= StatsPublishInterval;
+
+    if (m_data_context.is_dirty() || stats_refresh) {
+        m_data_context.clear_dirty();
+        snapshots.back() = m_data_context;
+        snapshots.publish();
+        m_last_publish = now;
+    }
+}
+
+void EventHandler::apply_event(const EventRecord& record)
+{
+    if (m_event_dump) {
+        m_event_dump->write(record);
+    }
+    m_data_context.add_callback_event(record);
+
+    switch (record.type) {
+        case EventType::resize: m_data_context.set_window_size(Size{record.x, record.y}); break;
+        case EventType::move: m_data_context.set_windos_position(Position{record.x, record.y}); break;
+        case EventType::mouse_move: m_data_context.set_window_cursor_position(Position{record.x, record.y}); break;
+        case EventType::key_up: run_key_action(record.key); break;
+        default: break;
+    }
+}
+
+void EventHandler::queue_event(const EventRecord& record)
+{
+    if (!m_events_queue.try_push(record)) {
+        m_dropped_events.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EventHandler::add_event(const EventRecord& record)
+{
+    flush_coalesced_event();
+    queue_event(record);
+}
+
+void EventHandler::add_coalescable_event(const EventRecord& record)
+{
+    if (!m_coalesce_events.load(std::memory_order_relaxed)) {
+        flush_coalesced_event();
+        queue_event(record);
+        return;
+    }
+
+    if (m_coalesced_event && m_coalesced_event->type == record.type) {
+        if (record.type == EventType::mouse_scroll) {
+            m_coalesced_event->x += record.x;
+            m_coalesced_event->y += record.y;
+        } else {
+            m_coalesced_event->x = record.x;
+            m_coalesced_event->y = record.y;
+        }
+        m_coalesced_events_count.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    flush_coalesced_event();
+    m_coalesced_event = record;
+}
+
+void EventHandler::flush_coalesced_event()
+{
+    if (m_coalesced_event) {
+        queue_event(*m_coalesced_event);
+        m_coalesced_event.reset();
     }
-    m_last_frame_time = Clock::now();
-    
-    m_data_context.set_fps(m_fps);
 }
 
 #pragma region actions handlers
@@ -411,4 +314,51 @@ void EventHandler::toggle_cursor_visible()
     m_window.set_cursor_visible(!m_window.is_cursor_visible());
 }
 
+void EventHandler::toggle_event_dump()
+{
+    if (m_event_dump) {
+        log::info("EventHandler") << "Dumped " << m_event_dump->records_count() << " events to " << EventDumpPath;
+        m_event_dump.reset();
+        return;
+    }
+
+    try {
+        m_event_dump = std::make_unique<EventDump>(EventDumpPath);
+    } catch (const std::runtime_error& e) {
+        log::error("EventHandler") << e.what();
+    }
+}
+
+void EventHandler::toggle_events_coalescing()
+{
+    // A pending coalesced event is queued by the producer with its next event or batch end.
+    m_coalesce_events.store(!m_coalesce_events.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void EventHandler::next_frame_pacing()
+{
+    switch (m_frame_pacing) {
+        case FramePacing::vsync: m_frame_pacing = FramePacing::fixed_rate; break;
+        case FramePacing::fixed_rate: m_frame_pacing = FramePacing::on_change; break;
+        case FramePacing::on_change: m_frame_pacing = FramePacing::vsync; break;
+    }
+}
+
+void EventHandler::toggle_trace()
+{
+    Tracer& tracer = Tracer::instance();
+    if (tracer.running()) {
+        tracer.stop();
+        log::info("EventHandler") << "Trace stopped, " << tracer.dropped_events() << " events dropped";
+        return;
+    }
+
+    try {
+        tracer.start(TracePath);
+        log::info("EventHandler") << "Tracing to " << TracePath;
+    } catch (const std::runtime_error& e) {
+        log::error("EventHandler") << e.what();
+    }
+}
+
 #pragma endregion
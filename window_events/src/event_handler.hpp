@@ -1,15 +1,28 @@
 #ifndef WINDOW_EVENTS_EVENT_HANDLER_HPP
 #define WINDOW_EVENTS_EVENT_HANDLER_HPP
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
 
 #include <system/window.hpp>
 
 #include "data_context.hpp"
+#include "event_dump.hpp"
+#include "event_record.hpp"
+#include "render_thread.hpp"
+#include "spsc_ring.hpp"
+#include "triple_buffer.hpp"
 
 class EventHandler
 {
 public:
+    static constexpr std::size_t CallbackEventsQueueSize = 1024;
+    static constexpr auto StatsPublishInterval = std::chrono::milliseconds(250);
+
     EventHandler(neutrino::system::Window& w);
 
     const DataContext& data_context() const;
@@ -35,11 +48,40 @@ public:
     void on_mouse_scroll(neutrino::system::ScrollOffset offset);
     void on_character(const std::string& s);
 
+    // Callbacks above and flush_events() are the producer side of the events queue and only
+    // capture records, on_update() is the consumer side and applies them. The two sides may run
+    // on different threads; everything they share is the queue and a few atomic counters.
+
+    // Ends a batch of callbacks, queues the pending coalesced event.
+    void flush_events();
+
+    // Moves queued events into the data context, runs the key actions and polls the window state.
     void on_update();
 
+    void set_render_stats(const RenderStats& stats);
+
+    // Copies the data context into the snapshots when anything in it changed since the last call.
+    // Render stats alone don't count as a change. Unless frames are paced on change, they are
+    // still published every StatsPublishInterval, the render thread draws continuously then.
+    void publish(TripleBuffer<DataContext>& snapshots);
+
 private:
-    using Clock = std::chrono::steady_clock;
-    
+    // When the queue is full the event is dropped and counted.
+    void queue_event(const EventRecord& record);
+
+    // Discrete events are queued in order, after any pending coalesced event.
+    void add_event(const EventRecord& record);
+
+    // Mouse moves and scrolls go through here. While coalescing is on, consecutive events of the
+    // same type are merged into one pending event, which keeps the first timestamp, the last
+    // position and the summed scroll offset.
+    void add_coalescable_event(const EventRecord& record);
+    void flush_coalesced_event();
+
+    // Consumer side handling of a queued event.
+    void apply_event(const EventRecord& record);
+    void run_key_action(neutrino::system::KeyCode key);
+
     // actions handlers
     void close_window();
     void toggle_fullscreen();
@@ -53,14 +95,27 @@ private:
     void toggle_cursor_capture();
     void toggle_cursor_visible();
 
+    void toggle_event_dump();
+    void toggle_events_coalescing();
+    void toggle_trace();
+    void next_frame_pacing();
+
     neutrino::system::Window& m_window;
 
     DataContext m_data_context;
-    
-    int m_fps = 0;
-    int m_current_fps = 0;
-    Clock::duration m_frame_counter_duration;
-    Clock::time_point m_last_frame_time;
+    SpscRing<EventRecord, CallbackEventsQueueSize> m_events_queue;
+    std::atomic<std::uint64_t> m_dropped_events = 0;
+    std::unique_ptr<EventDump> m_event_dump;
+
+    // Switched by the consumer, read by the producer.
+    std::atomic<bool> m_coalesce_events = false;
+    std::atomic<std::uint64_t> m_coalesced_events_count = 0;
+
+    // Producer side only.
+    std::optional<EventRecord> m_coalesced_event;
+
+    FramePacing m_frame_pacing = FramePacing::on_change;
+    std::chrono::steady_clock::time_point m_last_publish;
 };
 
 #endif
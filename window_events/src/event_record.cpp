@@ -0,0 +1,287 @@
+#include "event_record.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <string_view>
+
+using namespace neutrino;
+using namespace neutrino::system;
+
+namespace
+{
+
+std::string_view key_name(KeyCode key)
+{
+    switch (key) {
+        case KeyCode::unknown: return "unknown";
+
+        // Printable
+        case KeyCode::key_space: return "key_space";
+        case KeyCode::key_apostrophe: return "key_apostrophe";
+        case KeyCode::key_comma: return "key_comma";
+        case KeyCode::key_minus: return "key_minus";
+        case KeyCode::key_period: return "key_period";
+        case KeyCode::key_slash: return "key_slash";
+        case KeyCode::key_0: return "key_0";
+        case KeyCode::key_1: return "key_1";
+        case KeyCode::key_2: return "key_2";
+        case KeyCode::key_3: return "key_3";
+        case KeyCode::key_4: return "key_4";
+        case KeyCode::key_5: return "key_5";
+        case KeyCode::key_6: return "key_6";
+        case KeyCode::key_7: return "key_7";
+        case KeyCode::key_8: return "key_8";
+        case KeyCode::key_9: return "key_9";
+        case KeyCode::key_semicolon: return "key_semicolon";
+        case KeyCode::key_equal: return "key_equal";
+        case KeyCode::key_a: return "key_a";
+        case KeyCode::key_b: return "key_b";
+        case KeyCode::key_c: return "key_c";
+        case KeyCode::key_d: return "key_d";
+        case KeyCode::key_e: return "key_e";
+        case KeyCode::key_f: return "key_f";
+        case KeyCode::key_g: return "key_g";
+        case KeyCode::key_h: return "key_h";
+        case KeyCode::key_i: return "key_i";
+        case KeyCode::key_j: return "key_j";
+        case KeyCode::key_k: return "key_k";
+        case KeyCode::key_l: return "key_l";
+        case KeyCode::key_m: return "key_m";
+        case KeyCode::key_n: return "key_n";
+        case KeyCode::key_o: return "key_o";
+        case KeyCode::key_p: return "key_p";
+        case KeyCode::key_q: return "key_q";
+        case KeyCode::key_r: return "key_r";
+        case KeyCode::key_s: return "key_s";
+        case KeyCode::key_t: return "key_t";
+        case KeyCode::key_u: return "key_u";
+        case KeyCode::key_v: return "key_v";
+        case KeyCode::key_w: return "key_w";
+        case KeyCode::key_x: return "key_x";
+        case KeyCode::key_y: return "key_y";
+        case KeyCode::key_z: return "key_z";
+        case KeyCode::key_left_bracket: return "key_left_bracket";
+        case KeyCode::key_backslash: return "key_backslash";
+        case KeyCode::key_right_bracket: return "key_right_bracket";
+        case KeyCode::key_grave_accent: return "key_grave_accent";
+        case KeyCode::key_section: return "key_section";
+
+        // navigation
+        case KeyCode::key_escape: return "key_escape";
+        case KeyCode::key_enter: return "key_enter";
+        case KeyCode::key_tab: return "key_tab";
+        case KeyCode::key_backspace: return "key_backspace";
+        case KeyCode::key_insert: return "key_insert";
+        case KeyCode::key_delete: return "key_delete";
+        case KeyCode::key_right: return "key_right";
+        case KeyCode::key_left: return "key_left";
+        case KeyCode::key_down: return "key_down";
+        case KeyCode::key_up: return "key_up";
+        case KeyCode::key_page_up: return "key_page_up";
+        case KeyCode::key_page_down: return "key_page_down";
+        case KeyCode::key_home: return "key_home";
+        case KeyCode::key_end: return "key_end";
+        case KeyCode::key_caps_lock: return "key_caps_lock";
+        case KeyCode::key_scroll_lock: return "key_scroll_lock";
+        case KeyCode::key_num_lock: return "key_num_lock";
+        case KeyCode::key_print_screen: return "key_print_screen";
+        case KeyCode::key_pause: return "key_pause";
+
+        // Function keys
+        case KeyCode::key_f1: return "key_f1";
+        case KeyCode::key_f2: return "key_f2";
+        case KeyCode::key_f3: return "key_f3";
+        case KeyCode::key_f4: return "key_f4";
+        case KeyCode::key_f5: return "key_f5";
+        case KeyCode::key_f6: return "key_f6";
+        case KeyCode::key_f7: return "key_f7";
+        case KeyCode::key_f8: return "key_f8";
+        case KeyCode::key_f9: return "key_f9";
+        case KeyCode::key_f10: return "key_f10";
+        case KeyCode::key_f11: return "key_f11";
+        case KeyCode::key_f12: return "key_f12";
+        case KeyCode::key_f13: return "key_f13";
+        case KeyCode::key_f14: return "key_f14";
+        case KeyCode::key_f15: return "key_f15";
+        case KeyCode::key_f16: return "key_f16";
+        case KeyCode::key_f17: return "key_f17";
+        case KeyCode::key_f18: return "key_f18";
+        case KeyCode::key_f19: return "key_f19";
+        case KeyCode::key_f20: return "key_f20";
+        case KeyCode::key_f21: return "key_f21";
+        case KeyCode::key_f22: return "key_f22";
+        case KeyCode::key_f23: return "key_f23";
+        case KeyCode::key_f24: return "key_f24";
+
+        // numpad
+        case KeyCode::key_num_0: return "key_num_0";
+        case KeyCode::key_num_1: return "key_num_1";
+        case KeyCode::key_num_2: return "key_num_2";
+        case KeyCode::key_num_3: return "key_num_3";
+        case KeyCode::key_num_4: return "key_num_4";
+        case KeyCode::key_num_5: return "key_num_5";
+        case KeyCode::key_num_6: return "key_num_6";
+        case KeyCode::key_num_7: return "key_num_7";
+        case KeyCode::key_num_8: return "key_num_8";
+        case KeyCode::key_num_9: return "key_num_9";
+        case KeyCode::key_num_decimal: return "key_num_decimal";
+        case KeyCode::key_num_divide: return "key_num_divide";
+        case KeyCode::key_num_multiply: return "key_num_multiply";
+        case KeyCode::key_num_subtract: return "key_num_subtract";
+        case KeyCode::key_num_add: return "key_num_add";
+        case KeyCode::key_num_separator: return "key_num_separator";
+
+        // modifiers
+        case KeyCode::key_left_shift: return "key_left_shift";
+        case KeyCode::key_left_control: return "key_left_control";
+        case KeyCode::key_left_alt: return "key_left_alt";
+        case KeyCode::key_left_super: return "key_left_super";
+
+        case KeyCode::key_right_shift: return "key_right_shift";
+        case KeyCode::key_right_control: return "key_right_control";
+        case KeyCode::key_right_alt: return "key_right_alt";
+        case KeyCode::key_right_super: return "key_right_super";
+
+        case KeyCode::key_function: return "key_function";
+    }
+
+    return "undefined";
+}
+
+std::string_view button_name(MouseButton button)
+{
+    switch (button) {
+        case MouseButton::button_left: return "Left";
+        case MouseButton::button_right: return "Right";
+        case MouseButton::button_middle: return "Middle";
+        case MouseButton::button_4: return "Button_4";
+        case MouseButton::button_5: return "Button_5";
+        case MouseButton::button_6: return "Button_6";
+
+        case MouseButton::unknown: return "Unknown";
+    }
+
+    return "undefined";
+}
+
+void append_modifiers(std::string& out, const Modifiers state)
+{
+    if (state & Modifiers::shift) {
+        out += 'S';
+    }
+
+    if (state & Modifiers::control) {
+        out += 'C';
+    }
+
+    if (state & Modifiers::alt) {
+        out += 'M';
+    }
+
+    if (state & Modifiers::super) {
+        out += 'W';
+    }
+
+    if (state & Modifiers::caps_lock) {
+        out += 'L';
+    }
+
+    if (state & Modifiers::num_lock) {
+        out += 'N';
+    }
+
+    if (state & Modifiers::function) {
+        out += 'F';
+    }
+}
+
+void append_number(std::string& out, std::int64_t value)
+{
+    std::array<char, 24> digits;
+    const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    out.append(digits.data(), result.ptr);
+}
+
+void append_pair(std::string& out, std::int32_t x, std::int32_t y)
+{
+    out += '{';
+    append_number(out, x);
+    out += ", ";
+    append_number(out, y);
+    out += '}';
+}
+
+void append_key(std::string& out, const EventRecord& record)
+{
+    append_number(out, static_cast<std::int64_t>(record.key));
+    out += ' ';
+    out += key_name(record.key);
+    out += ' ';
+    append_modifiers(out, record.modifiers);
+}
+
+void append_button(std::string& out, const EventRecord& record)
+{
+    out += button_name(record.button);
+    out += ' ';
+    append_pair(out, record.x, record.y);
+    out += ' ';
+    append_modifiers(out, record.modifiers);
+}
+
+} // namespace
+
+std::int64_t event_timestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+void format_to(std::string& out, const EventRecord& record)
+{
+    switch (record.type) {
+        case EventType::show: out += "on_show"; break;
+        case EventType::hide: out += "on_hide"; break;
+        case EventType::close: out += "on_close"; break;
+        case EventType::focus: out += "on_focus"; break;
+        case EventType::focus_lost: out += "on_focus_lost"; break;
+        case EventType::resize:
+            out += "on_size: ";
+            append_pair(out, record.x, record.y);
+            break;
+        case EventType::move:
+            out += "on_position: ";
+            append_pair(out, record.x, record.y);
+            break;
+        case EventType::key_down:
+            out += "on_key_down key: ";
+            append_key(out, record);
+            break;
+        case EventType::key_up:
+            out += "on_key_up key: ";
+            append_key(out, record);
+            break;
+        case EventType::mouse_enter: out += "on_mouse_enter"; break;
+        case EventType::mouse_leave: out += "on_mouse_leave"; break;
+        case EventType::mouse_move:
+            out += "on_mouse_move ";
+            append_pair(out, record.x, record.y);
+            break;
+        case EventType::mouse_button_down:
+            out += "on_mouse_down: ";
+            append_button(out, record);
+            break;
+        case EventType::mouse_button_up:
+            out += "on_mouse_up: ";
+            append_button(out, record);
+            break;
+        case EventType::mouse_scroll:
+            out += "on_mouse_scroll: ";
+            append_pair(out, record.x, record.y);
+            break;
+        case EventType::character:
+            out += "on_character: ";
+            out.append(record.text.data(), record.text_size);
+            break;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef WINDOW_EVENTS_EVENT_RECORD_HPP
+#define WINDOW_EVENTS_EVENT_RECORD_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <system/window.hpp>
+
+enum class EventType : std::uint8_t
+{
+    show,
+    hide,
+    close,
+    focus,
+    focus_lost,
+    resize,
+    move,
+    key_down,
+    key_up,
+    mouse_enter,
+    mouse_leave,
+    mouse_move,
+    mouse_button_down,
+    mouse_button_up,
+    mouse_scroll,
+    character,
+};
+
+// Window callback event as plain data, turned into text only when it is displayed.
+struct EventRecord
+{
+    static constexpr std::size_t MaxTextSize = 8;
+
+    EventType type = EventType::show;
+    std::uint8_t text_size = 0;
+    neutrino::system::KeyCode key = neutrino::system::KeyCode::unknown;
+    neutrino::system::MouseButton button = neutrino::system::MouseButton::unknown;
+    neutrino::system::Modifiers modifiers = neutrino::system::Modifiers::none;
+
+    // Size, window position, cursor position or scroll offset, depending on the type.
+    std::int32_t x = 0;
+    std::int32_t y = 0;
+
+    // Steady clock time of the callback, in nanoseconds.
+    std::int64_t timestamp = 0;
+
+    // UTF-8 sequence of a character event, longer input is cut.
+    std::array<char, MaxTextSize> text{};
+};
+
+// Current time on the clock of EventRecord::timestamp.
+std::int64_t event_timestamp();
+
+// Appends the text of the record to out. Numbers are written with std::to_chars, so a buffer
+// that is cleared and reused between calls stops allocating once it has grown.
+void format_to(std::string& out, const EventRecord& record);
+
+#endif
@@ -0,0 +1,76 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+std::string_view frame_pacing_name(FramePacing pacing)
+{
+    switch (pacing) {
+        case FramePacing::vsync: return "VSync";
+        case FramePacing::fixed_rate: return "Fixed";
+        case FramePacing::on_change: return "On change";
+    }
+    return "";
+}
+
+FramePacer::FramePacer(FramePacing pacing, std::uint32_t target_fps)
+    : m_pacing(pacing),
+      m_next_frame(Clock::now())
+{
+    set_target_fps(target_fps);
+}
+
+void FramePacer::set_pacing(FramePacing pacing)
+{
+    if (m_pacing != pacing) {
+        m_pacing     = pacing;
+        m_next_frame = Clock::now();
+    }
+}
+
+FramePacing FramePacer::pacing() const
+{
+    return m_pacing;
+}
+
+void FramePacer::set_target_fps(std::uint32_t fps)
+{
+    m_frame_duration = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / std::max(fps, 1U);
+}
+
+bool FramePacer::should_render(bool changed) const
+{
+    return m_pacing != FramePacing::on_change || changed;
+}
+
+void FramePacer::wait()
+{
+    switch (m_pacing) {
+        case FramePacing::vsync: break;
+
+        case FramePacing::fixed_rate: {
+            // Deadlines advance by whole frames, so the rate does not drift with the wake-up
+            // error. A loop that fell more than a frame behind starts over instead of catching up.
+            const auto now = Clock::now();
+            m_next_frame += m_frame_duration;
+            if (m_next_frame + m_frame_duration < now) {
+                m_next_frame = now;
+            }
+            sleep_until(m_next_frame);
+            break;
+        }
+
+        case FramePacing::on_change: std::this_thread::sleep_for(IdlePollInterval); break;
+    }
+}
+
+void FramePacer::sleep_until(Clock::time_point deadline) const
+{
+    if (deadline - Clock::now() > SpinThreshold) {
+        std::this_thread::sleep_until(deadline - SpinThreshold);
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
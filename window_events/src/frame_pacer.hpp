@@ -0,0 +1,56 @@
+#ifndef WINDOW_EVENTS_FRAME_PACER_HPP
+#define WINDOW_EVENTS_FRAME_PACER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+enum class FramePacing : std::uint8_t
+{
+    // Renders every loop iteration, display() blocking on the swap interval paces the loop.
+    vsync,
+
+    // Renders every loop iteration at the target rate, sleeping between frames.
+    fixed_rate,
+
+    // Renders only when the displayed data changed, checked every IdlePollInterval.
+    on_change,
+};
+
+std::string_view frame_pacing_name(FramePacing pacing);
+
+// Decides whether a main loop iteration renders and how long the loop waits before the next one.
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::uint32_t DefaultTargetFps = 60;
+    static constexpr Clock::duration IdlePollInterval = std::chrono::milliseconds(5);
+
+    // Sleeps end this much before a deadline, the rest is spent yielding. OS sleeps overshoot
+    // by up to a scheduler tick, which is a large part of a frame at high rates.
+    static constexpr Clock::duration SpinThreshold = std::chrono::microseconds(1500);
+
+    explicit FramePacer(FramePacing pacing = FramePacing::on_change, std::uint32_t target_fps = DefaultTargetFps);
+
+    void set_pacing(FramePacing pacing);
+    FramePacing pacing() const;
+
+    void set_target_fps(std::uint32_t fps);
+
+    // changed tells whether the displayed data changed since the last rendered frame.
+    bool should_render(bool changed) const;
+
+    // Called at the end of a loop iteration, returns when the next one should start.
+    void wait();
+
+private:
+    void sleep_until(Clock::time_point deadline) const;
+
+    FramePacing m_pacing;
+    Clock::duration m_frame_duration;
+    Clock::time_point m_next_frame;
+};
+
+#endif
@@ -0,0 +1,36 @@
+#include "gl_context.hpp"
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#elif defined(__APPLE__)
+    #include <OpenGL/OpenGL.h>
+#else
+    #include <GL/glx.h>
+    #include <X11/Xlib.h>
+#endif
+
+void enable_window_threads()
+{
+#if !defined(_WIN32) && !defined(__APPLE__)
+    if (XInitThreads() == 0) {
+        throw std::runtime_error("Can't enable Xlib threads.");
+    }
+#endif
+}
+
+void release_current_context()
+{
+#if defined(_WIN32)
+    wglMakeCurrent(nullptr, nullptr);
+#elif defined(__APPLE__)
+    CGLSetCurrentContext(nullptr);
+#else
+    if (glXGetCurrentContext() != nullptr) {
+        glXMakeCurrent(glXGetCurrentDisplay(), None, nullptr);
+    }
+#endif
+}
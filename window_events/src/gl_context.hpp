@@ -0,0 +1,17 @@
+#ifndef WINDOW_EVENTS_GL_CONTEXT_HPP
+#define WINDOW_EVENTS_GL_CONTEXT_HPP
+
+// Platform calls the framework does not wrap, needed to move the window context to another thread.
+//
+// The framework context can be made current but not released, and GLX and WGL refuse to bind a
+// context that is still current on another thread. Both calls act on the calling thread only,
+// so they need no handles from the framework.
+
+// Lets the window system connection be used from several threads. Must be called before the
+// window is created: Xlib requires it before any other Xlib call, elsewhere it does nothing.
+void enable_window_threads();
+
+// Releases the OpenGL context current on the calling thread, if there is one.
+void release_current_context();
+
+#endif
@@ -0,0 +1,39 @@
+#include "latency_stats.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+void LatencyStats::add(std::int64_t sample)
+{
+    m_samples[m_next] = sample;
+    m_next            = (m_next + 1) % SamplesCount;
+    m_count           = std::min(m_count + 1, SamplesCount);
+}
+
+void LatencyStats::update()
+{
+    if (m_count == 0) {
+        return;
+    }
+
+    // Sample order does not matter for the stats, the first count entries are the valid ones.
+    const auto begin = m_scratch.begin();
+    const auto end   = begin + static_cast<std::ptrdiff_t>(m_count);
+    std::copy_n(m_samples.begin(), m_count, begin);
+
+    const auto p99 = begin + static_cast<std::ptrdiff_t>((m_count - 1) * 99 / 100);
+    std::nth_element(begin, p99, end);
+
+    m_p99  = *p99;
+    m_mean = std::accumulate(begin, end, std::int64_t{0}) / static_cast<std::int64_t>(m_count);
+}
+
+std::int64_t LatencyStats::mean() const
+{
+    return m_mean;
+}
+
+std::int64_t LatencyStats::p99() const
+{
+    return m_p99;
+}
@@ -0,0 +1,32 @@
+#ifndef WINDOW_EVENTS_LATENCY_STATS_HPP
+#define WINDOW_EVENTS_LATENCY_STATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Mean and 99th percentile over the last SamplesCount samples, without allocations.
+class LatencyStats
+{
+public:
+    static constexpr std::size_t SamplesCount = 256;
+
+    void add(std::int64_t sample);
+
+    // Recomputes the stats from the current samples.
+    void update();
+
+    // Zero until the first sample.
+    std::int64_t mean() const;
+    std::int64_t p99() const;
+
+private:
+    std::array<std::int64_t, SamplesCount> m_samples;
+    std::array<std::int64_t, SamplesCount> m_scratch;
+    std::size_t m_next  = 0;
+    std::size_t m_count = 0;
+    std::int64_t m_mean = 0;
+    std::int64_t m_p99  = 0;
+};
+
+#endif
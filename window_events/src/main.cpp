@@ -7,31 +7,52 @@
 #include <log/stream_logger.hpp>
 #include <system/window.hpp>
 
+#include "data_context.hpp"
 #include "event_handler.hpp"
-#include "view.hpp"
+#include "gl_context.hpp"
+#include "render_thread.hpp"
+#include "tracer.hpp"
+#include "triple_buffer.hpp"
 
 using namespace neutrino;
 using namespace neutrino::system;
 using neutrino::log::StreamLogger;
 
+namespace {
+
+// Events are polled at this rate whatever the frame rate, the render thread paces itself.
+constexpr auto EventPollInterval = std::chrono::milliseconds(2);
+
+} // namespace
+
 class App
 {
 public:
     App()
         : m_window("Window Events", {800, 600})
-        , m_view(m_window)
         , m_event_handler(m_window)
+        , m_render_thread(m_window, m_snapshots)
     {
         setup_callbacks();
     }
 
     void run()
     {
+        Tracer::instance().set_thread_name("events");
         m_window.show();
         while (!m_window.should_close()) {
-            m_window.process_events();
-            m_event_handler.on_update();
-            m_view.render(m_event_handler.data_context());
+            m_render_thread.check();
+
+            {
+                Tracer::Scope trace("events");
+                m_window.process_events();
+                m_event_handler.flush_events();
+                m_event_handler.on_update();
+                m_event_handler.set_render_stats(m_render_thread.stats());
+                m_event_handler.publish(m_snapshots);
+            }
+
+            std::this_thread::sleep_for(EventPollInterval);
         }
     }
 
@@ -43,10 +64,7 @@ private:
         m_window.set_on_close_callback([this]() { m_event_handler.on_close(); });
         m_window.set_on_focus_callback([this]() { m_event_handler.on_focus(); });
         m_window.set_on_lost_focus_callback([this]() { m_event_handler.on_lost_focus(); });
-        m_window.set_on_resize_callback([this](Size size) {
-            m_view.on_resize(size);
-            m_event_handler.on_resize(size);
-        });
+        m_window.set_on_resize_callback([this](Size size) { m_event_handler.on_resize(size); });
         m_window.set_on_move_callback([this](Position p) { m_event_handler.on_move(p); });
         m_window.set_on_key_down_callback(
         [this](KeyCode key, Modifiers state) { m_event_handler.on_key_down(key, state); });
@@ -64,8 +82,11 @@ private:
     }
 
     Window m_window;
-    View m_view;
     EventHandler m_event_handler;
+    TripleBuffer<DataContext> m_snapshots;
+
+    // Last, so it stops before the objects it uses are destroyed.
+    RenderThread m_render_thread;
 };
 
 int main()
@@ -73,6 +94,9 @@ int main()
     neutrino::log::set_logger(std::make_unique<StreamLogger>(std::cout));
     log::info("Main") << "RUN";
 
+    // Before the window exists, the render thread shares its connection with the event thread.
+    enable_window_threads();
+
     App app;
     app.run();
 }
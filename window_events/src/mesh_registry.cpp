@@ -0,0 +1,64 @@
+#include "mesh_registry.hpp"
+
+#include <algorithm>
+
+#include <log/log.hpp>
+
+using namespace neutrino;
+using namespace neutrino::graphics;
+
+MeshRegistry::MeshRegistry(Renderer& renderer)
+    : m_renderer(renderer)
+{
+}
+
+bool MeshRegistry::load(ResourceId id, const Mesh& mesh)
+{
+    if (m_entries.size() <= id) {
+        m_entries.resize(id + 1);
+    }
+
+    Entry& entry = m_entries[id];
+
+    if (entry.loaded && same_content(entry, mesh)) {
+        ++m_redundant_loads_count;
+        if (!entry.warned) {
+            log::warning("MeshRegistry") << "Mesh " << id << " reloaded with identical content, load skipped";
+            entry.warned = true;
+        }
+        return true;
+    }
+
+    ++m_loads_count;
+    entry.loaded = m_renderer.load(id, mesh);
+    entry.vertices.assign(mesh.vertices().begin(), mesh.vertices().end());
+    entry.submeshes.assign(mesh.submeshes().begin(), mesh.submeshes().end());
+    return entry.loaded;
+}
+
+std::uint64_t MeshRegistry::loads_count() const
+{
+    return m_loads_count;
+}
+
+std::uint64_t MeshRegistry::redundant_loads_count() const
+{
+    return m_redundant_loads_count;
+}
+
+bool MeshRegistry::same_content(const Entry& entry, const Mesh& mesh)
+{
+    const auto& vertices  = mesh.vertices();
+    const auto& submeshes = mesh.submeshes();
+
+    return std::equal(entry.vertices.begin(), entry.vertices.end(), vertices.begin(), vertices.end()) &&
+           std::equal(entry.submeshes.begin(), entry.submeshes.end(), submeshes.begin(), submeshes.end());
+}
+
+Mesh make_unit_quad()
+{
+    Mesh mesh;
+    mesh.set_vertices({{-0.5, -0.5, 0.0}, {0.5, -0.5, 0.0}, {0.5, 0.5, 0.0}, {-0.5, 0.5, 0.0}});
+    mesh.add_submesh({0, 1, 2, 0, 2, 3});
+    return mesh;
+}
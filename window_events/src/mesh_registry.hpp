@@ -0,0 +1,50 @@
+#ifndef WINDOW_EVENTS_MESH_REGISTRY_HPP
+#define WINDOW_EVENTS_MESH_REGISTRY_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <graphics/mesh.hpp>
+#include <graphics/renderer.hpp>
+
+// Loads meshes into the renderer and remembers what each resource id holds.
+//
+// Loading an id again with the same content does not reach the renderer: the load is skipped
+// and reported with a warning the first time it happens for the id, since it usually means a
+// mesh is rebuilt every frame instead of being created once. Content is compared in full, not
+// by hash, so a skipped load never leaves a different mesh on screen. Only positions and
+// indices are compared, meshes of View carry nothing else.
+class MeshRegistry
+{
+public:
+    using ResourceId = neutrino::graphics::Renderer::ResourceId;
+
+    explicit MeshRegistry(neutrino::graphics::Renderer& renderer);
+
+    bool load(ResourceId id, const neutrino::graphics::Mesh& mesh);
+
+    std::uint64_t loads_count() const;
+    std::uint64_t redundant_loads_count() const;
+
+private:
+    struct Entry
+    {
+        neutrino::graphics::Mesh::VertexData vertices;
+        std::vector<neutrino::graphics::Mesh::IndicesData> submeshes;
+        bool loaded = false;
+        bool warned = false;
+    };
+
+    static bool same_content(const Entry& entry, const neutrino::graphics::Mesh& mesh);
+
+    neutrino::graphics::Renderer& m_renderer;
+    std::vector<Entry> m_entries;
+
+    std::uint64_t m_loads_count           = 0;
+    std::uint64_t m_redundant_loads_count = 0;
+};
+
+// Shared immutable primitives, loaded once and drawn with a model matrix.
+neutrino::graphics::Mesh make_unit_quad();
+
+#endif
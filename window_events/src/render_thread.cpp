@@ -0,0 +1,103 @@
+#include "render_thread.hpp"
+
+#include <algorithm>
+
+#include "gl_context.hpp"
+#include "tracer.hpp"
+#include "view.hpp"
+
+using namespace neutrino;
+using namespace neutrino::system;
+
+RenderThread::RenderThread(Window& window, TripleBuffer<DataContext>& snapshots)
+    : m_window(window),
+      m_snapshots(snapshots)
+{
+    // A context still current here can't be made current on the render thread with GLX or WGL.
+    release_current_context();
+    m_thread = std::thread([this]() { run(); });
+}
+
+RenderThread::~RenderThread()
+{
+    m_stop.store(true, std::memory_order_relaxed);
+    m_thread.join();
+}
+
+RenderStats RenderThread::stats() const
+{
+    return {.frame              = m_frame_stats.summary(),
+            .input_latency_mean = m_input_latency_mean.load(std::memory_order_relaxed),
+            .input_latency_p99  = m_input_latency_p99.load(std::memory_order_relaxed)};
+}
+
+void RenderThread::check() const
+{
+    if (m_failed.load(std::memory_order_acquire)) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void RenderThread::run()
+{
+    Tracer::instance().set_thread_name("render");
+
+    try {
+        m_window.context().make_current();
+
+        View view(m_window);
+        Size size;
+
+        while (!m_stop.load(std::memory_order_relaxed)) {
+            const bool fresh        = m_snapshots.update();
+            const DataContext& data = m_snapshots.front();
+
+            m_pacer.set_pacing(data.frame_pacing());
+            if (m_pacer.should_render(fresh)) {
+                Tracer::Scope trace("frame");
+                m_frame_stats.begin_frame();
+
+                if (!(data.window_size() == size)) {
+                    size = data.window_size();
+                    view.on_resize(size);
+                }
+
+                view.render(data);
+
+                m_frame_stats.begin_display();
+                view.display();
+                m_frame_stats.end_frame();
+
+                on_frame_displayed(data);
+            }
+
+            m_pacer.wait();
+        }
+    } catch (...) {
+        m_error = std::current_exception();
+        m_failed.store(true, std::memory_order_release);
+    }
+
+    release_current_context();
+}
+
+void RenderThread::on_frame_displayed(const DataContext& data)
+{
+    // Events added since the last displayed frame are the newest ones of the log. A burst
+    // longer than the log only counts the events still in it.
+    const std::int64_t displayed_at = event_timestamp();
+    const std::uint64_t received    = data.callback_events_received();
+    const auto shown = static_cast<std::size_t>(
+    std::min<std::uint64_t>(received - m_displayed_events, data.callback_events_count()));
+    m_displayed_events = received;
+
+    if (shown > 0) {
+        for (std::size_t i = 0; i < shown; ++i) {
+            m_latency.add(displayed_at - data.callback_event(i).timestamp);
+        }
+        m_latency.update();
+
+        m_input_latency_mean.store(m_latency.mean(), std::memory_order_relaxed);
+        m_input_latency_p99.store(m_latency.p99(), std::memory_order_relaxed);
+    }
+}
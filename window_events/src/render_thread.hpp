@@ -0,0 +1,75 @@
+#ifndef WINDOW_EVENTS_RENDER_THREAD_HPP
+#define WINDOW_EVENTS_RENDER_THREAD_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <thread>
+
+#include <system/window.hpp>
+
+#include "data_context.hpp"
+#include "frame_pacer.hpp"
+#include "frame_stats.hpp"
+#include "latency_stats.hpp"
+#include "triple_buffer.hpp"
+
+// What the render thread measures, reported back to the event thread for display.
+struct RenderStats
+{
+    FrameStats::Summary frame;
+    std::int64_t input_latency_mean = 0;
+    std::int64_t input_latency_p99  = 0;
+};
+
+// Draws the newest DataContext snapshot on a thread of its own.
+//
+// The thread makes the window context current and owns the View, so display() blocking on the
+// swap interval never delays event processing. Frames are paced by the pacing mode of the
+// snapshot, a new snapshot counts as a change.
+//
+// The constructor hands the context over: it releases the context on the calling thread, which
+// must not use OpenGL afterwards, and the render thread releases it again before it ends. The
+// render thread touches the window only through its context, while the event thread keeps
+// processing events and querying the window state. That needs a window connection usable from
+// two threads, so enable_window_threads() must have been called before the window was created.
+class RenderThread
+{
+public:
+    RenderThread(neutrino::system::Window& window, TripleBuffer<DataContext>& snapshots);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&)            = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    RenderStats stats() const;
+
+    // Rethrows the exception that stopped the render thread, if any.
+    void check() const;
+
+private:
+    void run();
+    void on_frame_displayed(const DataContext& data);
+
+    neutrino::system::Window& m_window;
+    TripleBuffer<DataContext>& m_snapshots;
+
+    // Used by the render thread only.
+    FramePacer m_pacer;
+    LatencyStats m_latency;
+    std::uint64_t m_displayed_events = 0;
+
+    // Frames are timed from the start of rendering, pacing sleeps are not part of them.
+    FrameStats m_frame_stats;
+
+    std::atomic<std::int64_t> m_input_latency_mean = 0;
+    std::atomic<std::int64_t> m_input_latency_p99  = 0;
+
+    std::atomic<bool> m_stop   = false;
+    std::atomic<bool> m_failed = false;
+    std::exception_ptr m_error;
+
+    std::thread m_thread;
+};
+
+#endif
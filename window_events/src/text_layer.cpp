@@ -0,0 +1,118 @@
+#include "text_layer.hpp"
+
+using namespace neutrino;
+using namespace neutrino::graphics;
+
+TextLayer::TextLayer(Renderer& renderer,
+                     MeshRegistry& meshes,
+                     const Font& font,
+                     ResourceId batch_mesh_id,
+                     ResourceId shader_id,
+                     math::Vector3f scale,
+                     math::Vector4f color)
+    : m_renderer(renderer), m_meshes(meshes), m_font(font), m_batch_mesh_id(batch_mesh_id), m_shader_id(shader_id),
+      m_scale(scale), m_color(color)
+{
+}
+
+void TextLayer::draw(ResourceId id, std::string_view text, math::Vector3f position)
+{
+    Slot& s = slot(id);
+    if (!s.built || s.keyed || s.text != text)
+    {
+        s.text.assign(text);
+        s.keyed = false;
+        build(s);
+    }
+
+    add_line(id, s, position);
+}
+
+void TextLayer::submit()
+{
+    if (!m_batch_loaded || m_lines != m_batch_lines)
+    {
+        rebuild_batch();
+    }
+    m_lines.clear();
+
+    if (m_batch_indices.empty())
+    {
+        return;
+    }
+
+    // Lines are already in place, the batch is drawn untransformed.
+    m_renderer.render(m_batch_mesh_id, m_shader_id, {Uniform{"modelMatrix", math::Matrix4f()}, Uniform{"color", m_color}});
+}
+
+std::uint64_t TextLayer::builds_count() const
+{
+    return m_builds_count;
+}
+
+std::uint64_t TextLayer::uploads_count() const
+{
+    return m_uploads_count;
+}
+
+TextLayer::Slot& TextLayer::slot(ResourceId id)
+{
+    if (m_slots.size() <= id)
+    {
+        m_slots.resize(id + 1);
+    }
+    return m_slots[id];
+}
+
+void TextLayer::build(Slot& slot)
+{
+    const Mesh mesh = m_font.create_text_mesh(slot.text);
+
+    slot.vertices = mesh.vertices();
+    slot.indices.clear();
+    for (const auto& submesh : mesh.submeshes())
+    {
+        slot.indices.insert(slot.indices.end(), submesh.begin(), submesh.end());
+    }
+
+    slot.built = true;
+    ++slot.build;
+    ++m_builds_count;
+}
+
+void TextLayer::add_line(ResourceId id, const Slot& slot, math::Vector3f position)
+{
+    m_lines.push_back(Line{.id = id, .build = slot.build, .position = position});
+}
+
+void TextLayer::rebuild_batch()
+{
+    m_batch_vertices.clear();
+    m_batch_indices.clear();
+
+    for (const Line& line : m_lines)
+    {
+        const Slot& s = m_slots[line.id];
+        const auto first_vertex = static_cast<std::uint32_t>(m_batch_vertices.size());
+
+        // Same as the scale(translate(position), m_scale) model matrix of a single line.
+        for (const auto& v : s.vertices)
+        {
+            m_batch_vertices.push_back(
+            math::Vector3f{line.position.x + v.x * m_scale.x, line.position.y + v.y * m_scale.y, line.position.z + v.z * m_scale.z});
+        }
+
+        for (const auto index : s.indices)
+        {
+            m_batch_indices.push_back(first_vertex + index);
+        }
+    }
+
+    Mesh batch;
+    batch.set_vertices(m_batch_vertices);
+    batch.add_submesh(m_batch_indices);
+    m_batch_loaded = m_meshes.load(m_batch_mesh_id, batch);
+
+    m_batch_lines.swap(m_lines);
+    ++m_uploads_count;
+}
@@ -0,0 +1,119 @@
+#ifndef WINDOW_EVENTS_TEXT_LAYER_HPP
+#define WINDOW_EVENTS_TEXT_LAYER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <graphics/font.hpp>
+#include <graphics/mesh.hpp>
+#include <graphics/renderer.hpp>
+#include <math/math.hpp>
+
+#include "mesh_registry.hpp"
+
+// Retained, batched text: all lines drawn in a frame go out with one draw call.
+//
+// Every slot keeps the geometry of the last text drawn in it, and a slot's geometry is built
+// only when its text changes. submit() packs the lines of the frame, moved to their positions
+// on the CPU, into one batch mesh. The batch is reloaded only when the lines differ from the
+// previous frame, so unchanged text costs a single draw call per frame and nothing else.
+class TextLayer
+{
+public:
+    using ResourceId = neutrino::graphics::Renderer::ResourceId;
+
+    // The batch mesh is loaded through meshes, so repeated identical batches are reported.
+    TextLayer(neutrino::graphics::Renderer& renderer,
+              MeshRegistry& meshes,
+              const neutrino::graphics::Font& font,
+              ResourceId batch_mesh_id,
+              ResourceId shader_id,
+              neutrino::math::Vector3f scale,
+              neutrino::math::Vector4f color);
+
+    // Adds the text to the frame, its geometry is rebuilt only when it differs from the last
+    // text of the slot.
+    void draw(ResourceId id, std::string_view text, neutrino::math::Vector3f position);
+
+    // Same for text identified by key instead of by content: make_text(std::string&) is called to
+    // write the text only when the slot holds text of another key. Lets a caller skip even
+    // formatting text it has already drawn.
+    template <typename MakeText>
+    void draw(ResourceId id, std::uint64_t key, MakeText&& make_text, neutrino::math::Vector3f position);
+
+    // Draws all text added since the last call.
+    void submit();
+
+    // Slot geometry builds and batch reloads since creation, to check static text is really static.
+    std::uint64_t builds_count() const;
+    std::uint64_t uploads_count() const;
+
+private:
+    struct Slot
+    {
+        std::string text;
+        std::uint64_t key   = 0;
+        bool keyed          = false;
+        bool built          = false;
+        std::uint64_t build = 0;
+
+        neutrino::graphics::Mesh::VertexData vertices;
+        neutrino::graphics::Mesh::IndicesData indices;
+    };
+
+    struct Line
+    {
+        ResourceId id = 0;
+        std::uint64_t build = 0;
+        neutrino::math::Vector3f position;
+
+        bool operator==(const Line& other) const
+        {
+            return id == other.id && build == other.build && position == other.position;
+        }
+    };
+
+    Slot& slot(ResourceId id);
+    void build(Slot& slot);
+    void add_line(ResourceId id, const Slot& slot, neutrino::math::Vector3f position);
+    void rebuild_batch();
+
+    neutrino::graphics::Renderer& m_renderer;
+    MeshRegistry& m_meshes;
+    const neutrino::graphics::Font& m_font;
+    ResourceId m_batch_mesh_id;
+    ResourceId m_shader_id;
+    neutrino::math::Vector3f m_scale;
+    neutrino::math::Vector4f m_color;
+
+    std::vector<Slot> m_slots;
+    std::vector<Line> m_lines;
+    std::vector<Line> m_batch_lines;
+    bool m_batch_loaded = false;
+
+    neutrino::graphics::Mesh::VertexData m_batch_vertices;
+    neutrino::graphics::Mesh::IndicesData m_batch_indices;
+
+    std::uint64_t m_builds_count  = 0;
+    std::uint64_t m_uploads_count = 0;
+};
+
+template <typename MakeText>
+void TextLayer::draw(ResourceId id, std::uint64_t key, MakeText&& make_text, neutrino::math::Vector3f position)
+{
+    Slot& s = slot(id);
+    if (!s.built || !s.keyed || s.key != key)
+    {
+        s.text.clear();
+        make_text(s.text);
+        s.key   = key;
+        s.keyed = true;
+        build(s);
+    }
+
+    add_line(id, s, position);
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef WINDOW_EVENTS_TRIPLE_BUFFER_HPP
+#define WINDOW_EVENTS_TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one writer thread to one reader thread without locks.
+//
+// The writer fills the back buffer and publishes it, the reader takes the newest published
+// buffer as its front. Publishing swaps the back buffer with the middle one, taking it swaps
+// the front buffer with the middle one, so neither side ever waits for the other and the
+// reader never sees a buffer that is being written. Values published while the reader does
+// not look are skipped, only the newest one is read.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side.
+    T& back()
+    {
+        return m_buffers[m_back];
+    }
+
+    void publish()
+    {
+        m_back = m_middle.exchange(m_back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    // Reader side. Takes the newest value, returns false when nothing was published since
+    // the last call and the front is unchanged.
+    bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FreshBit) == 0) {
+            return false;
+        }
+
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    const T& front() const
+    {
+        return m_buffers[m_front];
+    }
+
+private:
+    static constexpr std::uint8_t IndexMask = 0x3;
+    static constexpr std::uint8_t FreshBit  = 0x4;
+
+    std::array<T, 3> m_buffers{};
+    std::uint8_t m_back  = 0;
+    std::uint8_t m_front = 1;
+    std::atomic<std::uint8_t> m_middle = 2;
+};
+
+#endif
@@ -10,6 +10,9 @@
 #include <math/math.hpp>
 
 #include "data_context.hpp"
+#include "event_record.hpp"
+#include "text_layer.hpp"
+#include "tracer.hpp"
 
 using namespace neutrino;
 using namespace neutrino::graphics;
@@ -51,9 +54,11 @@ void main()\n\
 
     constexpr int LogOffset = 50;
     constexpr math::Vector3f normal_text_scale = {15, 15, 1};
+    const math::Vector4f NormalTextColor = {0.9f, 0.5f, 0.6f, 1.0f};
 
     constexpr math::Vector3f WindowTextTopLeftOffset = {-300, -50, 0};
     constexpr math::Vector3f CursorTextTopLeftOffset = {-300, -150, 0};
+    constexpr math::Vector3f InputTextTopLeftOffset = {-300, -250, 0};
 
     constexpr math::Vector3f CatTextBottomRightOffset = {80, -63, 0};
     constexpr math::Vector3f FpsTextBottomRightOffset = {120, -50, 0};
@@ -77,7 +82,9 @@ void main()\n\
 } // namespace
 
 View::View(Window &window)
-    : m_renderer(window.context())
+    : m_renderer(window.context()),
+      m_meshes(m_renderer),
+      m_text(m_renderer, m_meshes, m_font, TextName::TextBatchMesh, m_shader_id, normal_text_scale, NormalTextColor)
 {
     if (m_font.load("data/UbuntuMono-Regular.ttf") != Font::LoadResult::Success)
     {
@@ -92,6 +99,11 @@ View::View(Window &window)
         throw std::runtime_error("Can't load shader.");
     }
 
+    if (!m_meshes.load(TextName::UnitQuadMesh, make_unit_quad()))
+    {
+        throw std::runtime_error("Can't load unit quad.");
+    }
+
     m_renderer.set_clear_color(Color(0x2F2F2FFFU));
 }
 
@@ -101,14 +113,31 @@ View::~View()
 
 void View::render(const DataContext &data)
 {
-    render_window_state(data);
-    render_cursor_state(data);
-    render_log(data);
+    Tracer::Scope trace("View::render");
+
+    {
+        Tracer::Scope panels_trace("panels");
+        render_window_state(data);
+        render_cursor_state(data);
+        render_input_state(data);
+    }
+    {
+        Tracer::Scope log_trace("log");
+        render_log(data);
+    }
     render_cat(data);
     render_fps(data);
+    {
+        Tracer::Scope text_trace("text submit");
+        m_text.submit();
+    }
 
     render_cursor_marker(data);
+}
 
+void View::display()
+{
+    Tracer::Scope trace("display");
     m_renderer.display();
 }
 
@@ -188,17 +217,73 @@ void View::render_cursor_state(const DataContext &data)
     ss.str("");
 }
 
+void View::render_input_state(const DataContext &data)
+{
+    const auto size = data.window_size();
+
+    math::Vector3f text_pos = math::Vector3f{size.width, size.height, 0} + InputTextTopLeftOffset;
+
+    render_normal_text(TextName::InputTitleText, "Input   v ", text_pos);
+    text_pos.y -= 15;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+
+    ss << "        +-> Coalesce: " << (data.events_coalescing() ? "[x]" : "[ ]");
+    render_normal_text(TextName::InputCoalescingText, ss.str(), text_pos);
+    text_pos.y -= 15;
+    ss.str("");
+
+    ss << "        +-> Merged:   " << data.coalesced_events();
+    render_normal_text(TextName::InputCoalescedText, ss.str(), text_pos);
+    text_pos.y -= 15;
+    ss.str("");
+
+    ss << "        +-> Mean:     " << static_cast<double>(data.input_latency_mean()) / 1e6 << " ms";
+    render_normal_text(TextName::InputLatencyMeanText, ss.str(), text_pos);
+    text_pos.y -= 15;
+    ss.str("");
+
+    ss << "        +-> P99:      " << static_cast<double>(data.input_latency_p99()) / 1e6 << " ms";
+    render_normal_text(TextName::InputLatencyP99Text, ss.str(), text_pos);
+    text_pos.y -= 15;
+    ss.str("");
+
+    ss << "        +-> Pacing:   " << frame_pacing_name(data.frame_pacing());
+    render_normal_text(TextName::InputFramePacingText, ss.str(), text_pos);
+    text_pos.y -= 15;
+    ss.str("");
+
+    // p50 / p99 / worst, the mean alone hides hitches.
+    const FrameStats::Summary &frame = data.frame_stats();
+    ss << "        +-> Frame:    " << frame.p50_ms << " / " << frame.p99_ms << " / " << frame.worst_ms << " ms";
+    render_normal_text(TextName::InputFrameTimesText, ss.str(), text_pos);
+    text_pos.y -= 15;
+    ss.str("");
+
+    ss << "        +-> Display:  " << frame.display_ms << " ms";
+    render_normal_text(TextName::InputDisplayTimeText, ss.str(), text_pos);
+    text_pos.y -= 15;
+    ss.str("");
+}
+
 void View::render_log(const DataContext &data)
 {
     int offset = LogOffset;
-    Renderer::ResourceId mesh_id = TextName::LogTextBegin;
 
-    for (const auto &message : data.last_callback_events())
+    // Every event keeps its slot while it is in the log, so a new event only moves the lines
+    // up. Events are formatted once, when they first become visible.
+    const std::uint64_t received = data.callback_events_received();
+    for (std::size_t i = 0; i < data.callback_events_count(); ++i)
     {
-        render_normal_text(static_cast<TextName>(mesh_id), message, {LogOffset, offset, 0});
+        const std::uint64_t sequence = received - 1 - i;
+        const auto mesh_id = static_cast<Renderer::ResourceId>(TextName::LogTextBegin +
+                                                               sequence % DataContext::MaxCallbackEvents);
+
+        const EventRecord &event = data.callback_event(i);
+        m_text.draw(mesh_id, sequence, [&event](std::string &out) { format_to(out, event); }, {LogOffset, offset, 0});
 
         offset += 15;
-        mesh_id++;
 
         if (offset > data.window_size().height - LogOffset)
         {
@@ -241,22 +326,13 @@ void View::render_fps(const DataContext &data)
     const auto size = data.window_size();
 
     math::Vector3f text_pos = math::Vector3f{size.width, 0, 0} - FpsTextBottomRightOffset;
-    render_normal_text(TextName::FpsText, std::to_string(data.fps()), text_pos);
+    render_normal_text(TextName::FpsText, std::to_string(data.frame_stats().fps), text_pos);
 }
 
 void View::render_cursor_marker(const DataContext &data)
 {
     const auto size = data.window_size();
 
-    const Mesh::VertexData vertices = {{-0.5, -0.5, 0.0}, {0.5, -0.5, 0.0}, {0.5, 0.5, 0.0}, {-0.5, 0.5, 0.0}};
-    Mesh::IndicesData indices = {0, 1, 2, 0, 2, 3};
-
-    Mesh mesh;
-    mesh.set_vertices(vertices);
-    mesh.add_submesh(indices);
-
-    m_renderer.load(TextName::CursorMarker, mesh);
-
     const auto p = data.window_cursor_position();
 
     math::Vector3f pos(p.x, p.y, 0.1);
@@ -268,16 +344,12 @@ void View::render_cursor_marker(const DataContext &data)
     pos = math::Vector3f(pos.x, size.height - pos.y, 0.1);
 
     const math::Matrix4f transform = scale(translate(math::Matrix4f(), pos), {2, 2, 1});
-    m_renderer.render(TextName::CursorMarker,
+    m_renderer.render(TextName::UnitQuadMesh,
                       m_shader_id,
                       {Uniform{"modelMatrix", transform}, Uniform{"color", math::Vector4f(0.5f, 0.9f, 0.6f, 1.0f)}});
 }
 
 void View::render_normal_text(TextName id, const std::string &text, math::Vector3f position)
 {
-    m_renderer.load(id, m_font.create_text_mesh(text));
-    const math::Matrix4f transform = scale(translate(math::Matrix4f(), position), normal_text_scale);
-    m_renderer.render(id,
-                      m_shader_id,
-                      {Uniform{"modelMatrix", transform}, Uniform{"color", math::Vector4f(0.9f, 0.5f, 0.6f, 1.0f)}});
+    m_text.draw(id, text, position);
 }
@@ -1,11 +1,16 @@
 #ifndef WINDOW_EVENTS_VIEW_HPP
 #define WINDOW_EVENTS_VIEW_HPP
 
+#include <string>
+
 #include <graphics/font.hpp>
 #include <graphics/renderer.hpp>
 #include <math/math.hpp>
 #include <system/window.hpp>
 
+#include "mesh_registry.hpp"
+#include "text_layer.hpp"
+
 class DataContext;
 
 class View
@@ -14,7 +19,9 @@ public:
     View(neutrino::system::Window& window);
     ~View();
 
+    // Draws the frame, display() shows it.
     void render(const DataContext& data);
+    void display();
 
     void on_resize(neutrino::Size size);
 
@@ -33,18 +40,32 @@ private:
         CursorCapturedText,
         CursorVisibleText,
         MouseHoverText,
-        CursorMarker,
+
+        InputTitleText,
+        InputCoalescingText,
+        InputCoalescedText,
+        InputLatencyMeanText,
+        InputLatencyP99Text,
+        InputFramePacingText,
+        InputFrameTimesText,
+        InputDisplayTimeText,
+
+        UnitQuadMesh,
 
         CatText,
         CatText1,
 
         FpsText,
 
+        // Mesh of all text lines of the frame, see TextLayer.
+        TextBatchMesh,
+
         LogTextBegin,
     };
 
     void render_window_state(const DataContext& data);
     void render_cursor_state(const DataContext& data);
+    void render_input_state(const DataContext& data);
     void render_log(const DataContext& data);
     void render_cat(const DataContext& data);
     void render_fps(const DataContext& data);
@@ -55,6 +76,10 @@ private:
     neutrino::graphics::Renderer m_renderer;
     neutrino::graphics::Font m_font;
     neutrino::graphics::Renderer::ResourceId m_shader_id = 1;
+
+    MeshRegistry m_meshes;
+
+    TextLayer m_text;
 };
 
 #endif